@@ -0,0 +1,39 @@
+#pragma once
+#include <vector>
+#include "Resecs\Resecs.h"
+#include "BenchHarness.hpp"
+#include "BenchComponents.hpp"
+
+using namespace Resecs;
+
+namespace AddRemoveBench {
+	using namespace Bench;
+
+	/* Entity::Add/Remove of Velocity on entities that have Position, in a world with no groups. */
+	inline void Run() {
+		auto& report = Report::Instance();
+		const char* suite = "AddRemove";
+		if (!report.Begin(suite))
+			return;
+		for (auto count : report.EntityCounts({ 10000, 100000, 1000000, 2000000 })) {
+			World world;
+			auto entities = world.CreateMany(count, Position{ 0, 0, 0 });
+			std::vector<double> addSamples, removeSamples;
+			for (int i = 0; i < report.options.repetitions; i++)
+			{
+				addSamples.push_back(TimeMs([&]() {
+					for (auto& entity : entities) {
+						entity.Add(Velocity{ 1, 2, 3 });
+					}
+				}));
+				removeSamples.push_back(TimeMs([&]() {
+					for (auto& entity : entities) {
+						entity.Remove<Velocity>();
+					}
+				}));
+			}
+			report.AddTime(suite, "Add", count, Median(addSamples), count);
+			report.AddTime(suite, "Remove", count, Median(removeSamples), count);
+		}
+	}
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+namespace Bench {
+	struct Position {
+		float x, y, z;
+	};
+	struct Velocity {
+		float x, y, z;
+	};
+	/* Distinct 16-byte components for suites that vary the component count, Field<0> to Field<5>. */
+	template<int I>
+	struct Field {
+		float value[4];
+	};
+}
@@ -0,0 +1,170 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <initializer_list>
+
+namespace Bench {
+
+	/* One row of the report, e.g. suite "Each", name "3 components", 100000 entities, {"ms", 1.2}, {"ns_per_entity", 12}. */
+	struct Result {
+		std::string suite;
+		std::string name;
+		size_t entities;
+		std::vector<std::pair<std::string, double>> metrics;
+	};
+
+	/* Command line of resecsBench:
+	--json <file>         write every result to file as JSON.
+	--filter <text>       only run suites whose name contains text.
+	--max-entities <n>    skip entity counts above n, default 2000000.
+	--repetitions <n>     timings are the median of n runs, default 5.
+	*/
+	struct Options {
+		std::string jsonPath;
+		std::string filter;
+		size_t maxEntities = 2000000;
+		int repetitions = 5;
+
+		bool Parse(int argc, char** argv) {
+			for (int i = 1; i < argc; i++)
+			{
+				bool hasValue = i + 1 < argc;
+				if (strcmp(argv[i], "--json") == 0 && hasValue)
+					jsonPath = argv[++i];
+				else if (strcmp(argv[i], "--filter") == 0 && hasValue)
+					filter = argv[++i];
+				else if (strcmp(argv[i], "--max-entities") == 0 && hasValue)
+					maxEntities = strtoull(argv[++i], nullptr, 10);
+				else if (strcmp(argv[i], "--repetitions") == 0 && hasValue)
+					repetitions = std::max(1, atoi(argv[++i]));
+				else
+				{
+					printf("usage: %s [--json file] [--filter suite] [--max-entities n] [--repetitions n]\n", argv[0]);
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+
+	/* Collects results of all suites, prints them as they come and writes them as JSON at the end. */
+	class Report {
+	public:
+		static Report& Instance() {
+			static Report report;
+			return report;
+		}
+		Options options;
+
+		/* Whether suite is selected by --filter, prints the suite header if so. */
+		bool Begin(const char* suite) {
+			if (!options.filter.empty() && std::string(suite).find(options.filter) == std::string::npos)
+				return false;
+			printf("\n[%s]\n", suite);
+			return true;
+		}
+		/* The entity counts a suite runs with, those above --max-entities are dropped. */
+		std::vector<size_t> EntityCounts(std::initializer_list<size_t> counts) const {
+			std::vector<size_t> result;
+			for (auto count : counts) {
+				if (count <= options.maxEntities)
+					result.push_back(count);
+			}
+			return result;
+		}
+
+		void Add(Result result) {
+			printf("  %-40s %9zu", result.name.c_str(), result.entities);
+			for (auto& metric : result.metrics) {
+				printf("  %12.3f %s", metric.second, metric.first.c_str());
+			}
+			printf("\n");
+			m_results.push_back(std::move(result));
+		}
+		/* Add a timing, ops is what the per-op cost is divided by, usually the entity count. */
+		void AddTime(const char* suite, const std::string& name, size_t entities, double ms, size_t ops) {
+			Add({ suite, name, entities, { { "ms", ms }, { "ns_per_op", ops ? ms * 1e6 / ops : 0 } } });
+		}
+
+		bool WriteJson() const {
+			if (options.jsonPath.empty())
+				return true;
+			FILE* file = fopen(options.jsonPath.c_str(), "w");
+			if (file == nullptr) {
+				printf("Can't open %s\n", options.jsonPath.c_str());
+				return false;
+			}
+			fprintf(file, "{\n  \"repetitions\": %d,\n  \"results\": [", options.repetitions);
+			for (size_t i = 0; i < m_results.size(); i++)
+			{
+				auto& result = m_results[i];
+				fprintf(file, "%s\n    {\"suite\": \"%s\", \"name\": \"%s\", \"entities\": %zu",
+					i == 0 ? "" : ",", escape(result.suite).c_str(), escape(result.name).c_str(), result.entities);
+				for (auto& metric : result.metrics) {
+					fprintf(file, ", \"%s\": %.6g", escape(metric.first).c_str(), metric.second);
+				}
+				fprintf(file, "}");
+			}
+			fprintf(file, "\n  ]\n}\n");
+			fclose(file);
+			printf("\nWrote %zu results to %s\n", m_results.size(), options.jsonPath.c_str());
+			return true;
+		}
+	private:
+		static std::string escape(const std::string& text) {
+			std::string result;
+			for (char c : text) {
+				if (c == '"' || c == '\\')
+					result.push_back('\\');
+				result.push_back(c);
+			}
+			return result;
+		}
+		std::vector<Result> m_results;
+	};
+
+	/* Milliseconds taken by one call of func. */
+	template<typename TFunc>
+	double TimeMs(TFunc&& func) {
+		auto start = std::chrono::high_resolution_clock::now();
+		func();
+		auto end = std::chrono::high_resolution_clock::now();
+		return std::chrono::duration<double, std::milli>(end - start).count();
+	}
+
+	/* Median of samples, less noisy than the mean when a run gets preempted. */
+	inline double Median(std::vector<double> samples) {
+		std::sort(samples.begin(), samples.end());
+		size_t middle = samples.size() / 2;
+		return samples.size() % 2 ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2;
+	}
+
+	/* Median milliseconds of --repetitions calls of func. */
+	template<typename TFunc>
+	double MedianMs(TFunc&& func) {
+		std::vector<double> samples;
+		for (int i = 0; i < Report::Instance().options.repetitions; i++)
+		{
+			samples.push_back(TimeMs(func));
+		}
+		return Median(samples);
+	}
+
+	/* Median milliseconds of func, setup runs untimed before every call, e.g. to rebuild the world it consumes. */
+	template<typename TSetup, typename TFunc>
+	double MedianMs(TSetup&& setup, TFunc&& func) {
+		std::vector<double> samples;
+		for (int i = 0; i < Report::Instance().options.repetitions; i++)
+		{
+			setup();
+			samples.push_back(TimeMs(func));
+		}
+		return Median(samples);
+	}
+}
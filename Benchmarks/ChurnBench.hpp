@@ -0,0 +1,61 @@
+#pragma once
+#include <vector>
+#include "Resecs\Resecs.h"
+#include "BenchHarness.hpp"
+#include "BenchComponents.hpp"
+
+using namespace Resecs;
+
+namespace ChurnBench {
+	using namespace Bench;
+
+	/* World::Create/Destroy, on their own and as churn: every other entity is destroyed and respawned with 2 components. */
+	inline void Run() {
+		auto& report = Report::Instance();
+		const char* suite = "Churn";
+		if (!report.Begin(suite))
+			return;
+		for (auto count : report.EntityCounts({ 10000, 100000, 1000000, 2000000 })) {
+			std::unique_ptr<World> world;
+			std::vector<Entity> entities;
+			auto createMs = MedianMs([&]() { world.reset(new World()); }, [&]() {
+				for (size_t i = 0; i < count; i++)
+				{
+					world->Create();
+				}
+			});
+			report.AddTime(suite, "Create", count, createMs, count);
+
+			auto destroyMs = MedianMs([&]() {
+				world.reset(new World());
+				entities.clear();
+				for (size_t i = 0; i < count; i++)
+				{
+					entities.push_back(world->Create());
+				}
+			}, [&]() {
+				for (auto& entity : entities) {
+					entity.Destroy();
+				}
+			});
+			report.AddTime(suite, "Destroy", count, destroyMs, count);
+
+			world.reset(new World());
+			entities = world->CreateMany(count, Position{ 0, 0, 0 }, Velocity{ 1, 2, 3 });
+			auto churnMs = MedianMs([&]() {
+				for (size_t i = 0; i < count; i += 2)
+				{
+					entities[i].Destroy();
+				}
+				for (size_t i = 0; i < count; i += 2)
+				{
+					entities[i] = world->Create();
+					entities[i].Add(Position{ 0, 0, 0 });
+					entities[i].Add(Velocity{ 1, 2, 3 });
+				}
+			});
+			//one destroy and one create per respawned entity.
+			report.AddTime(suite, "Destroy + respawn half, 2 components", count, churnMs, count);
+		}
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "Resecs\Resecs.h"
+#include "BenchHarness.hpp"
+#include "BenchComponents.hpp"
+
+using namespace Resecs;
+
+namespace CreateManyBench {
+	using namespace Bench;
+
+	/* Spawn entityCount entities with Position and Velocity, one by one and with CreateMany, while a Group is listening. */
+	inline void Run() {
+		auto& report = Report::Instance();
+		const char* suite = "CreateMany";
+		if (!report.Begin(suite))
+			return;
+		for (auto count : report.EntityCounts({ 10000, 100000, 1000000 })) {
+			std::unique_ptr<World> world;
+			std::unique_ptr<Group> group;
+			auto setup = [&]() {
+				group.reset();
+				world.reset(new World());
+				group.reset(new Group(Group::CreateGroup<Position, Velocity>(world.get())));
+			};
+			auto perEntityMs = MedianMs(setup, [&]() {
+				for (size_t j = 0; j < count; j++)
+				{
+					auto entity = world->Create();
+					entity.Add(Position{ 0, 0, 0 });
+					entity.Add(Velocity{ 1, 2, 3 });
+				}
+			});
+			report.AddTime(suite, "Create + Add, 2 components", count, perEntityMs, count);
+			auto bulkMs = MedianMs(setup, [&]() {
+				world->CreateMany(count, Position{ 0, 0, 0 }, Velocity{ 1, 2, 3 });
+			});
+			report.AddTime(suite, "CreateMany, 2 components", count, bulkMs, count);
+			group.reset();
+		}
+	}
+}
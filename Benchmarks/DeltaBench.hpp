@@ -0,0 +1,53 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Resecs\Resecs.h"
+#include "BenchHarness.hpp"
+#include "BenchComponents.hpp"
+
+using namespace Resecs;
+
+namespace DeltaBench {
+	using namespace Bench;
+
+	/* Record, encode and apply a frame where changeCount entities got a Position write, in worlds of growing size.
+	The cost should follow changeCount, not the entity count.
+	*/
+	inline void Run(size_t changeCount = 10000) {
+		auto& report = Report::Instance();
+		const char* suite = "Delta";
+		if (!report.Begin(suite))
+			return;
+		using Replication = DeltaRecorder<Position, Velocity>;
+		for (auto count : report.EntityCounts({ 100000, 1000000, 2000000 })) {
+			World source, mirror;
+			Replication recorder(&source);
+			auto entities = source.CreateMany(count, Position{ 0, 0, 0 }, Velocity{ 1, 2, 3 });
+			Delta delta;
+			recorder.Flush(delta);
+			Replication::Apply(mirror, delta);
+
+			std::vector<char> bytes;
+			size_t stride = count / changeCount;
+			auto recordMs = MedianMs([&]() {
+				for (size_t i = 0; i < count; i += stride)
+				{
+					entities[i].GetMut<Position>()->x += 1;
+				}
+			}, [&]() {
+				recorder.Flush(delta);
+				bytes.clear();
+				delta.Encode(bytes);
+			});
+			std::string name = std::to_string(changeCount) + " writes";
+			report.Add({ suite, "Flush + Encode, " + name, count, { { "ms", recordMs }, { "ns_per_op", recordMs * 1e6 / changeCount }, { "bytes", double(bytes.size()) } } });
+
+			auto applyMs = MedianMs([&]() {
+				Delta received;
+				received.Decode(bytes.data(), bytes.size());
+				Replication::Apply(mirror, received);
+			});
+			report.AddTime(suite, "Decode + Apply, " + name, count, applyMs, changeCount);
+		}
+	}
+}
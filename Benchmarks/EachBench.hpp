@@ -0,0 +1,40 @@
+#pragma once
+#include <string>
+#include <utility>
+#include "Resecs\Resecs.h"
+#include "BenchHarness.hpp"
+#include "BenchComponents.hpp"
+
+using namespace Resecs;
+
+namespace EachBench {
+	using namespace Bench;
+
+	template<size_t... Is>
+	void runWith(const char* suite, size_t count, std::index_sequence<Is...>) {
+		World world;
+		world.CreateMany(count, Field<int(Is)>{}...);
+		auto ms = MedianMs([&]() {
+			world.Each<Field<int(Is)>...>([](Entity entity, Field<int(Is)>*... fields) {
+				((fields->value[0] += 1.0f), ...);
+			});
+		});
+		Report::Instance().AddTime(suite, std::to_string(sizeof...(Is)) + " components", count, ms, count);
+	}
+
+	/* World::Each over entities having 1 to 6 components, every entity matches. */
+	inline void Run() {
+		auto& report = Report::Instance();
+		const char* suite = "Each";
+		if (!report.Begin(suite))
+			return;
+		for (auto count : report.EntityCounts({ 10000, 100000, 1000000, 2000000 })) {
+			runWith(suite, count, std::make_index_sequence<1>());
+			runWith(suite, count, std::make_index_sequence<2>());
+			runWith(suite, count, std::make_index_sequence<3>());
+			runWith(suite, count, std::make_index_sequence<4>());
+			runWith(suite, count, std::make_index_sequence<5>());
+			runWith(suite, count, std::make_index_sequence<6>());
+		}
+	}
+}
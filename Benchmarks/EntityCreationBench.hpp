@@ -0,0 +1,40 @@
+#pragma once
+#include <vector>
+#include "Resecs\Resecs.h"
+#include "BenchHarness.hpp"
+
+using namespace Resecs;
+
+namespace EntityCreationBench {
+	using namespace Bench;
+
+	/* Create 2M entities into a world whose entity slots are 90% used. */
+	inline void Run(size_t entityCount = 2000000) {
+		auto& report = Report::Instance();
+		const char* suite = "EntityCreation";
+		if (!report.Begin(suite))
+			return;
+		entityCount = std::min(entityCount, report.options.maxEntities);
+		std::unique_ptr<World> world;
+		auto ms = MedianMs([&]() {
+			world.reset(new World());
+			std::vector<Entity> entities;
+			entities.reserve(entityCount);
+			for (size_t i = 0; i < entityCount; i++)
+			{
+				entities.push_back(world->Create());
+			}
+			//free every 10th slot, scattered over the whole table.
+			for (size_t i = 0; i < entityCount; i += 10)
+			{
+				entities[i].Destroy();
+			}
+		}, [&]() {
+			for (size_t i = 0; i < entityCount; i++)
+			{
+				world->Create();
+			}
+		});
+		report.AddTime(suite, "Create into a 90% full world", entityCount, ms, entityCount);
+	}
+}
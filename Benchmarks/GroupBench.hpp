@@ -0,0 +1,80 @@
+#pragma once
+#include <vector>
+#include "Resecs\Resecs.h"
+#include "BenchHarness.hpp"
+#include "BenchComponents.hpp"
+
+using namespace Resecs;
+
+namespace GroupBench {
+	using namespace Bench;
+
+	/* Add/Remove Velocity on every entity while group is listening, so each entity enters and leaves it. */
+	inline void measureMaintenance(const char* suite, const char* name, World& world, std::vector<Entity>& entities) {
+		auto& report = Report::Instance();
+		std::vector<double> enterSamples, leaveSamples;
+		for (int i = 0; i < report.options.repetitions; i++)
+		{
+			enterSamples.push_back(TimeMs([&]() {
+				for (auto& entity : entities) {
+					entity.Add(Velocity{ 1, 2, 3 });
+				}
+			}));
+			leaveSamples.push_back(TimeMs([&]() {
+				for (auto& entity : entities) {
+					entity.Remove<Velocity>();
+				}
+			}));
+		}
+		report.AddTime(suite, std::string(name) + " enter(Add)", entities.size(), Median(enterSamples), entities.size());
+		report.AddTime(suite, std::string(name) + " leave(Remove)", entities.size(), Median(leaveSamples), entities.size());
+	}
+
+	/* Group<Position, Velocity> iteration, plain and owning, and the cost of keeping groups up to date. */
+	inline void Run() {
+		auto& report = Report::Instance();
+		const char* suite = "Group";
+		if (!report.Begin(suite))
+			return;
+		const float dt = 1.0f / 60;
+		auto update = [=](Entity entity, Position* pPos, Velocity* pVel) {
+			pPos->x += pVel->x * dt;
+			pPos->y += pVel->y * dt;
+			pPos->z += pVel->z * dt;
+		};
+		for (auto count : report.EntityCounts({ 10000, 100000, 1000000, 2000000 })) {
+			{
+				World world;
+				//interleave with entities outside the group, so members are scattered in the pools.
+				for (size_t i = 0; i < count; i++)
+				{
+					auto member = world.Create();
+					member.Add(Position{ 0, 0, 0 });
+					member.Add(Velocity{ 1, 2, 3 });
+					world.Create().Add(Position{ 0, 0, 0 });
+				}
+				auto group = Group::CreateGroup<Position, Velocity>(&world);
+				report.AddTime(suite, "Each", count, MedianMs([&]() { group.Each<Position, Velocity>(update); }), count);
+				report.AddTime(suite, "range-for + Get", count, MedianMs([&]() {
+					for (auto entity : group) {
+						update(entity, entity.Get<Position>(), entity.Get<Velocity>());
+					}
+				}), count);
+				auto owning = Group::CreateOwningGroup<Position, Velocity>(&world);
+				report.AddTime(suite, "owning Each", count, MedianMs([&]() { owning.Each<Position, Velocity>(update); }), count);
+			}
+			{
+				World world;
+				auto entities = world.CreateMany(count, Position{ 0, 0, 0 });
+				auto group = Group::CreateGroup<Position, Velocity>(&world);
+				measureMaintenance(suite, "maintain", world, entities);
+			}
+			{
+				World world;
+				auto entities = world.CreateMany(count, Position{ 0, 0, 0 });
+				auto group = Group::CreateOwningGroup<Position, Velocity>(&world);
+				measureMaintenance(suite, "maintain owning", world, entities);
+			}
+		}
+	}
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <memory>
+#include <functional>
+#include <string>
+#include "Resecs\Resecs.h"
+#include "BenchHarness.hpp"
+#include "BenchComponents.hpp"
+#include "MemoryTracker.hpp"
+
+using namespace Resecs;
+
+namespace MemoryBench {
+	using namespace Bench;
+
+	/* Heap bytes held by the world after populate, including spare capacity of its vectors.
+	populate may return a group, which is counted too.
+	*/
+	inline void measure(const char* suite, const char* name, size_t count, std::function<std::unique_ptr<Group>(World&)> populate) {
+		size_t before = LiveBytes();
+		std::unique_ptr<World> world(new World());
+		auto group = populate(*world);
+		size_t bytes = LiveBytes() - before;
+		group.reset();
+		Report::Instance().Add({ suite, name, count, { { "bytes", double(bytes) }, { "bytes_per_entity", double(bytes) / count } } });
+	}
+
+	/* Memory footprint per entity, as counted by the replacement operator new. */
+	inline void Run() {
+		auto& report = Report::Instance();
+		const char* suite = "Memory";
+		if (!report.Begin(suite))
+			return;
+		for (auto count : report.EntityCounts({ 10000, 100000, 1000000, 2000000 })) {
+			measure(suite, "no component", count, [=](World& world) {
+				for (size_t i = 0; i < count; i++)
+				{
+					world.Create();
+				}
+				return nullptr;
+			});
+			measure(suite, "Position + Velocity, Create + Add", count, [=](World& world) {
+				for (size_t i = 0; i < count; i++)
+				{
+					auto entity = world.Create();
+					entity.Add(Position{ 0, 0, 0 });
+					entity.Add(Velocity{ 1, 2, 3 });
+				}
+				return nullptr;
+			});
+			measure(suite, "Position + Velocity, CreateMany", count, [=](World& world) {
+				world.CreateMany(count, Position{ 0, 0, 0 }, Velocity{ 1, 2, 3 });
+				return nullptr;
+			});
+			measure(suite, "Position + Velocity, CreateMany + Group", count, [=](World& world) {
+				world.CreateMany(count, Position{ 0, 0, 0 }, Velocity{ 1, 2, 3 });
+				return std::unique_ptr<Group>(new Group(Group::CreateGroup<Position, Velocity>(&world)));
+			});
+		}
+
+		//10k entities stay alive through a burst of spawns, what's left after the burst is gone, then after World::Compact().
+		const size_t steadyCount = 10000;
+		for (auto burstCount : report.EntityCounts({ 1000000 })) {
+			size_t before = LiveBytes();
+			std::unique_ptr<World> world(new World());
+			world->CreateMany(steadyCount, Position{ 0, 0, 0 }, Velocity{ 1, 2, 3 });
+			auto burst = world->CreateMany(burstCount, Position{ 0, 0, 0 }, Velocity{ 1, 2, 3 });
+			for (auto& entity : burst) {
+				entity.Destroy();
+			}
+			burst = std::vector<Entity>();
+			size_t afterBurst = LiveBytes() - before;
+			world->Compact();
+			size_t compacted = LiveBytes() - before;
+			auto name = "after a burst of " + std::to_string(burstCount);
+			report.Add({ suite, name, steadyCount, { { "bytes", double(afterBurst) }, { "bytes_per_entity", double(afterBurst) / steadyCount } } });
+			report.Add({ suite, name + ", Compact", steadyCount, { { "bytes", double(compacted) }, { "bytes_per_entity", double(compacted) / steadyCount } } });
+		}
+
+		//time to destroy a populated World with a group, memory from the global heap, from a pooled Arena destroyed afterwards,
+		//or from a monotonic Arena that is Reset() for the next World.
+		for (auto count : report.EntityCounts({ 100000, 1000000 })) {
+			enum class Memory { Heap, Pooled, Monotonic };
+			auto teardown = [&](const std::string& name, Memory memory) {
+				std::unique_ptr<Arena> arena;
+				if (memory == Memory::Monotonic)
+					arena.reset(new Arena(1 << 20, std::pmr::get_default_resource(), Arena::Mode::Monotonic));
+				std::unique_ptr<World> world;
+				std::unique_ptr<Group> group;
+				auto ms = MedianMs([&] {
+					if (memory == Memory::Pooled)
+						arena.reset(new Arena());
+					world.reset(new World(arena != nullptr ? static_cast<std::pmr::memory_resource*>(arena.get()) : std::pmr::get_default_resource()));
+					world->CreateMany(count, Position{ 0, 0, 0 }, Velocity{ 1, 2, 3 });
+					group.reset(new Group(Group::CreateGroup<Position, Velocity>(world.get())));
+				}, [&] {
+					group.reset();
+					world.reset();
+					if (memory == Memory::Monotonic)
+						arena->Reset();
+					else
+						arena.reset();
+				});
+				report.AddTime(suite, name, count, ms, count);
+			};
+			teardown("teardown, global heap", Memory::Heap);
+			teardown("teardown, pooled Arena", Memory::Pooled);
+			teardown("teardown, monotonic Arena + Reset", Memory::Monotonic);
+		}
+	}
+}
@@ -0,0 +1,95 @@
+#include <new>
+#include <atomic>
+#include <cstdlib>
+#include <cstdint>
+#include "MemoryTracker.hpp"
+
+/* Replacement of the global operator new/delete that counts live bytes, for the memory footprint suite.
+Every block is prefixed with a header holding the requested size and the pointer returned by malloc,
+so the plain and the aligned forms share one delete path.
+*/
+namespace {
+	struct AllocationHeader {
+		void* raw;
+		size_t size;
+	};
+	std::atomic<size_t> g_liveBytes{ 0 };
+
+	void* allocate(size_t size, size_t alignment) {
+		if (alignment < alignof(AllocationHeader))
+			alignment = alignof(AllocationHeader);
+		void* raw = std::malloc(size + sizeof(AllocationHeader) + alignment);
+		if (raw == nullptr)
+			throw std::bad_alloc();
+		uintptr_t address = (reinterpret_cast<uintptr_t>(raw) + sizeof(AllocationHeader) + alignment - 1) & ~uintptr_t(alignment - 1);
+		auto header = reinterpret_cast<AllocationHeader*>(address) - 1;
+		header->raw = raw;
+		header->size = size;
+		g_liveBytes += size;
+		return reinterpret_cast<void*>(address);
+	}
+	void deallocate(void* p) {
+		if (p == nullptr)
+			return;
+		auto header = static_cast<AllocationHeader*>(p) - 1;
+		g_liveBytes -= header->size;
+		std::free(header->raw);
+	}
+}
+
+namespace Bench {
+	size_t LiveBytes() {
+		return g_liveBytes;
+	}
+}
+
+void* operator new(size_t size) {
+	return allocate(size, alignof(std::max_align_t));
+}
+void* operator new[](size_t size) {
+	return allocate(size, alignof(std::max_align_t));
+}
+void* operator new(size_t size, std::align_val_t alignment) {
+	return allocate(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+	return allocate(size, static_cast<size_t>(alignment));
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+	try { return allocate(size, alignof(std::max_align_t)); }
+	catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+	try { return allocate(size, alignof(std::max_align_t)); }
+	catch (...) { return nullptr; }
+}
+void operator delete(void* p) noexcept {
+	deallocate(p);
+}
+void operator delete[](void* p) noexcept {
+	deallocate(p);
+}
+void operator delete(void* p, size_t) noexcept {
+	deallocate(p);
+}
+void operator delete[](void* p, size_t) noexcept {
+	deallocate(p);
+}
+void operator delete(void* p, std::align_val_t) noexcept {
+	deallocate(p);
+}
+void operator delete[](void* p, std::align_val_t) noexcept {
+	deallocate(p);
+}
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+	deallocate(p);
+}
+void operator delete[](void* p, size_t, std::align_val_t) noexcept {
+	deallocate(p);
+}
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+	deallocate(p);
+}
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+	deallocate(p);
+}
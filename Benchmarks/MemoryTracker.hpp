@@ -0,0 +1,9 @@
+#pragma once
+#include <cstddef>
+
+namespace Bench {
+	/* Bytes currently allocated through operator new, counted by the replacement operators in MemoryTracker.cpp.
+	Only meaningful on one thread, other threads allocating in between are counted too.
+	*/
+	size_t LiveBytes();
+}
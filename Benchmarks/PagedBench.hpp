@@ -0,0 +1,73 @@
+#pragma once
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include "Resecs\Resecs.h"
+#include "BenchHarness.hpp"
+
+using namespace Resecs;
+
+namespace PagedBench {
+	using namespace Bench;
+
+	/* 64-byte components, stored in one vector or in pages of 1024. */
+	struct Body {
+		float value[16];
+	};
+	struct PagedBody {
+		using Paging = Resecs::Paged<1024>;
+		float value[16];
+	};
+
+	/* Entity::Add of T one entity at a time, with the slowest Add, which is where a vector pool reallocates. */
+	template<typename T>
+	void add(const char* suite, const char* name, size_t count) {
+		auto& report = Report::Instance();
+		std::vector<double> totals, worsts;
+		for (int i = 0; i < report.options.repetitions; i++)
+		{
+			World world;
+			auto entities = world.CreateMany(count);
+			double total = 0;
+			double worst = 0;
+			for (auto& entity : entities) {
+				auto start = std::chrono::high_resolution_clock::now();
+				entity.Add(T{});
+				auto end = std::chrono::high_resolution_clock::now();
+				double ms = std::chrono::duration<double, std::milli>(end - start).count();
+				total += ms;
+				worst = std::max(worst, ms);
+			}
+			totals.push_back(total);
+			worsts.push_back(worst);
+		}
+		double ms = Median(totals);
+		report.Add({ suite, name, count, { { "ms", ms }, { "ns_per_op", ms * 1e6 / count }, { "worst_ms", Median(worsts) } } });
+	}
+
+	template<typename T>
+	void each(const char* suite, const char* name, size_t count) {
+		World world;
+		world.CreateMany(count, T{});
+		auto ms = MedianMs([&]() {
+			world.Each<T>([](Entity entity, T* pBody) {
+				pBody->value[0] += 1.0f;
+			});
+		});
+		Report::Instance().AddTime(suite, name, count, ms, count);
+	}
+
+	/* Vector pools against paged pools: growth spikes and iteration cost. */
+	inline void Run() {
+		auto& report = Report::Instance();
+		const char* suite = "Paged";
+		if (!report.Begin(suite))
+			return;
+		for (auto count : report.EntityCounts({ 10000, 100000, 1000000, 2000000 })) {
+			add<Body>(suite, "Add, vector pool", count);
+			add<PagedBody>(suite, "Add, paged pool", count);
+			each<Body>(suite, "Each, vector pool", count);
+			each<PagedBody>(suite, "Each, paged pool", count);
+		}
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <string>
+#include <thread>
+#include "Resecs\Resecs.h"
+#include "BenchHarness.hpp"
+#include "BenchComponents.hpp"
+
+using namespace Resecs;
+
+namespace ParallelEachBench {
+	using namespace Bench;
+
+	/* Position += Velocity * dt over 1M entities, with 1 to hardware_concurrency threads. */
+	inline void Run(size_t entityCount = 1000000) {
+		auto& report = Report::Instance();
+		const char* suite = "ParallelEach";
+		if (!report.Begin(suite))
+			return;
+		entityCount = std::min(entityCount, report.options.maxEntities);
+		World world;
+		world.CreateMany(entityCount, Position{ 0, 0, 0 }, Velocity{ 1, 2, 3 });
+
+		const float dt = 1.0f / 60;
+		size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+		for (size_t threads = 1; threads <= maxThreads; threads++)
+		{
+			ThreadPool pool(threads);
+			world.SetThreadPool(&pool);
+			auto ms = MedianMs([&]() {
+				world.ParallelEach<Position, Velocity>([=](Entity entity, Position* pPos, Velocity* pVel) {
+					pPos->x += pVel->x * dt;
+					pPos->y += pVel->y * dt;
+					pPos->z += pVel->z * dt;
+				}, 16 * 1024);
+			});
+			report.AddTime(suite, std::to_string(threads) + " threads", entityCount, ms, entityCount);
+		}
+		world.SetThreadPool(nullptr);
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Resecs\Resecs.h"
+#include "BenchHarness.hpp"
+
+using namespace Resecs;
+
+namespace SignalBench {
+	using namespace Bench;
+
+	/* Signal::Invoke with 0 to 16 listeners, entities is the number of invocations here. */
+	inline void Run() {
+		auto& report = Report::Instance();
+		const char* suite = "Signal";
+		if (!report.Begin(suite))
+			return;
+		const size_t invocations = 1000000;
+		for (int listeners : { 0, 1, 4, 16 }) {
+			Signal<int> signal;
+			std::vector<Signal<int>::SignalConnection> connections;
+			volatile int sink = 0;
+			for (int i = 0; i < listeners; i++)
+			{
+				connections.push_back(signal.Connect([&](int value) { sink = sink + value; }));
+			}
+			auto ms = MedianMs([&]() {
+				for (size_t i = 0; i < invocations; i++)
+				{
+					signal.Invoke(int(i));
+				}
+			});
+			report.AddTime(suite, "Invoke, " + std::to_string(listeners) + " listeners", invocations, ms, invocations);
+		}
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdio>
+#include <memory>
+#include "Resecs\Resecs.h"
+#include "BenchHarness.hpp"
+#include "BenchComponents.hpp"
+
+using namespace Resecs;
+
+namespace SnapshotBench {
+	using namespace Bench;
+
+	/* Save and load a world of entityCount entities with Position and Velocity, against rebuilding it with Create + Add. */
+	inline void Run(size_t entityCount = 1000000) {
+		auto& report = Report::Instance();
+		const char* suite = "Snapshot";
+		if (!report.Begin(suite))
+			return;
+		entityCount = std::min(entityCount, report.options.maxEntities);
+		const char* path = "resecs_snapshot_bench.bin";
+		{
+			World world;
+			world.CreateMany(entityCount, Position{ 0, 0, 0 }, Velocity{ 1, 2, 3 });
+			auto saveMs = MedianMs([&]() { Snapshot::Save<Position, Velocity>(world, path); });
+			report.AddTime(suite, "Save", entityCount, saveMs, entityCount);
+		}
+
+		std::unique_ptr<World> world;
+		auto reset = [&]() { world.reset(new World()); };
+		auto loadMs = MedianMs(reset, [&]() { Snapshot::Load<Position, Velocity>(*world, path); });
+		report.AddTime(suite, "Load", entityCount, loadMs, entityCount);
+		auto rebuildMs = MedianMs(reset, [&]() {
+			for (size_t i = 0; i < entityCount; i++)
+			{
+				auto entity = world->Create();
+				entity.Add(Position{ 0, 0, 0 });
+				entity.Add(Velocity{ 1, 2, 3 });
+			}
+		});
+		report.AddTime(suite, "rebuild with Create + Add", entityCount, rebuildMs, entityCount);
+		auto createManyMs = MedianMs(reset, [&]() { world->CreateMany(entityCount, Position{ 0, 0, 0 }, Velocity{ 1, 2, 3 }); });
+		report.AddTime(suite, "rebuild with CreateMany", entityCount, createManyMs, entityCount);
+		world.reset();
+		std::remove(path);
+	}
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include "Resecs\Resecs.h"
+#include "BenchHarness.hpp"
+#include "BenchComponents.hpp"
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define RESECS_BENCH_SSE
+#endif
+
+using namespace Resecs;
+
+namespace SoABench {
+	using namespace Bench;
+
+	struct SoAPosition {
+		float x, y, z;
+		using SoALayout = SoAFields<&SoAPosition::x, &SoAPosition::y, &SoAPosition::z>;
+	};
+	struct SoAVelocity {
+		float x, y, z;
+		using SoALayout = SoAFields<&SoAVelocity::x, &SoAVelocity::y, &SoAVelocity::z>;
+	};
+
+	/* Position += Velocity * dt over 1M entities, array-of-structs against struct-of-arrays columns. */
+	inline void Run(size_t entityCount = 1000000) {
+		auto& report = Report::Instance();
+		const char* suite = "SoA";
+		if (!report.Begin(suite))
+			return;
+		entityCount = std::min(entityCount, report.options.maxEntities);
+		const float dt = 1.0f / 60;
+		World aosWorld;
+		aosWorld.CreateMany(entityCount, Position{ 0, 0, 0 }, Velocity{ 1, 2, 3 });
+		World soaWorld;
+		soaWorld.CreateMany(entityCount, SoAPosition{ 0, 0, 0 }, SoAVelocity{ 1, 2, 3 });
+
+		auto viewMs = MedianMs([&]() {
+			aosWorld.Each<Position, Velocity>([=](Entity entity, Position* pPos, Velocity* pVel) {
+				pPos->x += pVel->x * dt;
+				pPos->y += pVel->y * dt;
+				pPos->z += pVel->z * dt;
+			});
+		});
+		report.AddTime(suite, "AoS World::Each", entityCount, viewMs, entityCount);
+
+		auto chunkMs = MedianMs([&]() {
+			aosWorld.ForEachChunk<Mut<Position>, Velocity>([=](size_t count, const EntityID* entities, Position* pPos, const Velocity* pVel) {
+				for (size_t i = 0; i < count; i++)
+				{
+					pPos[i].x += pVel[i].x * dt;
+					pPos[i].y += pVel[i].y * dt;
+					pPos[i].z += pVel[i].z * dt;
+				}
+			});
+		});
+		report.AddTime(suite, "AoS World::ForEachChunk", entityCount, chunkMs, entityCount);
+
+		auto aosGroup = Group::CreateOwningGroup<Position, Velocity>(&aosWorld);
+		auto aosMs = MedianMs([&]() {
+			aosGroup.Each<Position, Velocity>([=](Entity entity, Position* pPos, Velocity* pVel) {
+				pPos->x += pVel->x * dt;
+				pPos->y += pVel->y * dt;
+				pPos->z += pVel->z * dt;
+			});
+		});
+		report.AddTime(suite, "AoS owning Group", entityCount, aosMs, entityCount);
+
+		auto soaGroup = Group::CreateOwningGroup<SoAPosition, SoAVelocity>(&soaWorld);
+		auto columnMs = MedianMs([&]() {
+			float* px = soaGroup.Column<&SoAPosition::x>();
+			float* py = soaGroup.Column<&SoAPosition::y>();
+			float* pz = soaGroup.Column<&SoAPosition::z>();
+			const float* vx = soaGroup.Column<&SoAVelocity::x>();
+			const float* vy = soaGroup.Column<&SoAVelocity::y>();
+			const float* vz = soaGroup.Column<&SoAVelocity::z>();
+			size_t count = soaGroup.Count();
+			//separate loops over contiguous floats, auto-vectorized by the compiler.
+			for (size_t i = 0; i < count; i++)
+				px[i] += vx[i] * dt;
+			for (size_t i = 0; i < count; i++)
+				py[i] += vy[i] * dt;
+			for (size_t i = 0; i < count; i++)
+				pz[i] += vz[i] * dt;
+		});
+		report.AddTime(suite, "SoA columns", entityCount, columnMs, entityCount);
+
+#ifdef RESECS_BENCH_SSE
+		auto sseMs = MedianMs([&]() {
+			float* positions[] = { soaGroup.Column<&SoAPosition::x>(), soaGroup.Column<&SoAPosition::y>(), soaGroup.Column<&SoAPosition::z>() };
+			const float* velocities[] = { soaGroup.Column<&SoAVelocity::x>(), soaGroup.Column<&SoAVelocity::y>(), soaGroup.Column<&SoAVelocity::z>() };
+			size_t count = soaGroup.Count();
+			__m128 dt4 = _mm_set1_ps(dt);
+			for (int axis = 0; axis < 3; axis++)
+			{
+				float* p = positions[axis];
+				const float* v = velocities[axis];
+				size_t i = 0;
+				for (; i + 4 <= count; i += 4)
+					_mm_storeu_ps(p + i, _mm_add_ps(_mm_loadu_ps(p + i), _mm_mul_ps(_mm_loadu_ps(v + i), dt4)));
+				for (; i < count; i++)
+					p[i] += v[i] * dt;
+			}
+		});
+		report.AddTime(suite, "SoA columns, SSE", entityCount, sseMs, entityCount);
+#endif
+	}
+}
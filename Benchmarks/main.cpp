@@ -0,0 +1,36 @@
+#include <Resecs\Resecs.h>
+
+#include "BenchHarness.hpp"
+#include "ChurnBench.hpp"
+#include "AddRemoveBench.hpp"
+#include "EachBench.hpp"
+#include "GroupBench.hpp"
+#include "SignalBench.hpp"
+#include "MemoryBench.hpp"
+#include "ParallelEachBench.hpp"
+#include "EntityCreationBench.hpp"
+#include "CreateManyBench.hpp"
+#include "SnapshotBench.hpp"
+#include "DeltaBench.hpp"
+#include "SoABench.hpp"
+#include "PagedBench.hpp"
+
+int main(int argc, char** argv) {
+	auto& report = Bench::Report::Instance();
+	if (!report.options.Parse(argc, argv))
+		return 1;
+	ChurnBench::Run();
+	AddRemoveBench::Run();
+	EachBench::Run();
+	GroupBench::Run();
+	SignalBench::Run();
+	MemoryBench::Run();
+	ParallelEachBench::Run();
+	EntityCreationBench::Run();
+	CreateManyBench::Run();
+	SnapshotBench::Run();
+	DeltaBench::Run();
+	SoABench::Run();
+	PagedBench::Run();
+	return report.WriteJson() ? 0 : 1;
+}
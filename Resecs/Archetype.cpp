@@ -0,0 +1,102 @@
+#include "Archetype.h"
+using namespace Resecs;
+
+Resecs::Archetype::Archetype(const ComponentActivationBitset & signature, const std::pmr::vector<ComponentTypeInfo>& typeInfos, std::pmr::memory_resource* resource) :
+	addEdges(resource),
+	removeEdges(resource),
+	m_resource(resource),
+	m_signature(signature),
+	m_chunks(resource) {
+	//columns are sorted by component index.
+	size_t rowSize = sizeof(EntityID);
+	size_t alignmentPadding = 0;
+	for (size_t i = 0; i < typeInfos.size(); i++)
+	{
+		if (!signature.test(i))
+			continue;
+		Column column;
+		column.componentIndex = i;
+		column.info = typeInfos[i];
+		column.offset = 0;
+		m_columns.push_back(column);
+		rowSize += column.info.size;
+		alignmentPadding += column.info.align;
+	}
+	if (alignmentPadding + rowSize > ChunkSize) {
+		throw std::runtime_error("Components of an archetype don't fit in a chunk!");
+	}
+	m_capacity = (ChunkSize - alignmentPadding) / rowSize;
+
+	//lay columns out one after another, each aligned for its type.
+	size_t offset = m_capacity * sizeof(EntityID);
+	for (auto& column : m_columns) {
+		offset = (offset + column.info.align - 1) / column.info.align * column.info.align;
+		column.offset = offset;
+		offset += m_capacity * column.info.size;
+	}
+	m_chunkBytes = offset;
+	m_chunkAlignment = alignof(EntityID);
+	for (auto& column : m_columns) {
+		m_chunkAlignment = std::max(m_chunkAlignment, column.info.align);
+	}
+
+	for (size_t i = 0; i < m_columns.size(); i++)
+	{
+		EnlargeVectorToFit(m_columnOfComponent, m_columns[i].componentIndex, -1);
+		m_columnOfComponent[m_columns[i].componentIndex] = i;
+	}
+}
+
+Resecs::Archetype::~Archetype() {
+	//walk the rows only for columns that need it.
+	for (size_t i = 0; i < m_columns.size(); i++)
+	{
+		if (m_columns[i].info.triviallyDestructible)
+			continue;
+		for (size_t row = 0; row < m_count; row++)
+		{
+			m_columns[i].info.destruct(ComponentAt(row, i));
+		}
+	}
+	for (auto chunk : m_chunks) {
+		m_resource->deallocate(chunk, m_chunkBytes, m_chunkAlignment);
+	}
+}
+
+size_t Resecs::Archetype::AddRow(EntityID entity) {
+	if (m_count == m_chunks.size() * m_capacity) {
+		m_chunks.reserve(m_chunks.size() + 1);
+		m_chunks.push_back(m_resource->allocate(m_chunkBytes, m_chunkAlignment));
+	}
+	auto row = m_count++;
+	EntityAt(row) = entity;
+	return row;
+}
+
+EntityID Resecs::Archetype::EraseRow(size_t row) {
+	auto last = m_count - 1;
+	if (row != last) {
+		for (size_t i = 0; i < m_columns.size(); i++)
+		{
+			auto& info = m_columns[i].info;
+			info.moveConstruct(ComponentAt(row, i), ComponentAt(last, i));
+			info.destruct(ComponentAt(last, i));
+		}
+		EntityAt(row) = EntityAt(last);
+	}
+	auto moved = EntityAt(row);
+	m_count--;
+	//release the last chunk once it's empty.
+	if (m_count <= (m_chunks.size() - 1) * m_capacity) {
+		m_resource->deallocate(m_chunks.back(), m_chunkBytes, m_chunkAlignment);
+		m_chunks.pop_back();
+	}
+	return moved;
+}
+
+void Resecs::Archetype::DestructRow(size_t row) {
+	for (size_t i = 0; i < m_columns.size(); i++)
+	{
+		m_columns[i].info.destruct(ComponentAt(row, i));
+	}
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <unordered_map>
+#include <new>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include "EntityID.hpp"
+#include "World.h"
+
+namespace Resecs {
+
+	/* Type erased operations of a component type, used by Archetype to move components between chunks. */
+	struct ComponentTypeInfo {
+		size_t size;
+		size_t align;
+		void(*moveConstruct)(void* dst, void* src);
+		void(*destruct)(void* ptr);
+		bool triviallyDestructible;	//destruct can be skipped when the archetype goes away.
+
+		template<typename T>
+		static ComponentTypeInfo Of() {
+			ComponentTypeInfo info;
+			info.size = sizeof(T);
+			info.align = alignof(T);
+			info.moveConstruct = [](void* dst, void* src) {
+				new (dst) T(std::move(*static_cast<T*>(src)));
+			};
+			info.destruct = [](void* ptr) {
+				static_cast<T*>(ptr)->~T();
+			};
+			info.triviallyDestructible = std::is_trivially_destructible<T>::value;
+			return info;
+		}
+	};
+
+	/* All entities with exactly the same set of components.
+	Entities are stored in fixed-size chunks, a chunk holds an EntityID array followed by one array(column) per component type.
+	Rows are always packed, removing a row moves the last row into it.
+	Chunks and bookkeeping allocate from the memory resource of the ArchetypeWorld.
+	*/
+	class Archetype {
+	public:
+		const static size_t ChunkSize = 16 * 1024;
+
+		struct Column {
+			int componentIndex;
+			ComponentTypeInfo info;
+			size_t offset;	//offset of the column inside a chunk.
+		};
+
+		/* Throws if a row of the components(plus alignment padding) doesn't fit in ChunkSize. */
+		Archetype(const ComponentActivationBitset& signature, const std::pmr::vector<ComponentTypeInfo>& typeInfos, std::pmr::memory_resource* resource);
+		Archetype(const Archetype& copy) = delete;
+		~Archetype();
+
+		/* Components every entity in this archetype has. */
+		const ComponentActivationBitset& GetSignature() const { return m_signature; }
+
+		/* Column position of a component type, -1 if the archetype doesn't have it. */
+		int GetColumn(int componentIndex) const {
+			if (static_cast<size_t>(componentIndex) >= m_columnOfComponent.size())
+				return -1;
+			return m_columnOfComponent[componentIndex];
+		}
+		const std::pmr::vector<Column>& GetColumns() const { return m_columns; }
+
+		/* Rows per chunk. */
+		size_t Capacity() const { return m_capacity; }
+		/* Total rows. */
+		size_t Count() const { return m_count; }
+		size_t ChunkCount() const { return m_chunks.size(); }
+		/* Rows used in given chunk. */
+		size_t ChunkRowCount(size_t chunk) const {
+			return std::min(m_capacity, m_count - chunk * m_capacity);
+		}
+
+		EntityID* ChunkEntities(size_t chunk) {
+			return static_cast<EntityID*>(m_chunks[chunk]);
+		}
+		void* ChunkColumn(size_t chunk, int column) {
+			return static_cast<char*>(m_chunks[chunk]) + m_columns[column].offset;
+		}
+		void* ComponentAt(size_t row, int column) {
+			return static_cast<char*>(ChunkColumn(row / m_capacity, column)) + (row % m_capacity) * m_columns[column].info.size;
+		}
+		EntityID& EntityAt(size_t row) {
+			return ChunkEntities(row / m_capacity)[row % m_capacity];
+		}
+
+		/* Append a row for entity, components of the new row are NOT constructed. */
+		size_t AddRow(EntityID entity);
+		/* Remove a row whose components were already destructed or moved out.
+		The last row is moved into its place, returns the entity that now lives at row(or the removed entity if row was the last one).
+		*/
+		EntityID EraseRow(size_t row);
+		/* Destruct all components at row. */
+		void DestructRow(size_t row);
+
+		/* Cached transitions to the archetype with one more / one less component. */
+		std::pmr::unordered_map<int, Archetype*> addEdges;
+		std::pmr::unordered_map<int, Archetype*> removeEdges;
+	private:
+		std::pmr::memory_resource* m_resource;
+		ComponentActivationBitset m_signature;
+		std::pmr::vector<Column> m_columns{ m_resource };
+		std::pmr::vector<int> m_columnOfComponent{ m_resource };
+		std::pmr::vector<void*> m_chunks;	//m_chunkBytes each, allocated from m_resource.
+		size_t m_capacity;
+		size_t m_chunkBytes;	//bytes used by a chunk, at most ChunkSize.
+		size_t m_chunkAlignment;	//largest alignment of the columns, chunks start on it so every column is aligned.
+		size_t m_count = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "ArchetypeWorld.h"
+using namespace Resecs;
+
+Resecs::ArchetypeWorld::ArchetypeWorld(std::pmr::memory_resource* resource) : m_resource(resource) {
+	m_emptyArchetype = getArchetype(ComponentActivationBitset());
+}
+
+EntityID Resecs::ArchetypeWorld::Create() {
+	EntityIndex_t index;
+	if (m_freeIndices.size() > 0) {
+		index = m_freeIndices.back();
+		m_freeIndices.pop_back();
+	}
+	else
+	{
+		index = m_records.size();
+		m_records.push_back(EntityRecord{ nullptr, 0, 0, false });
+	}
+	auto& record = m_records[index];
+	auto entityID = EntityID(index, record.generation);
+	record.alive = true;
+	record.archetype = m_emptyArchetype;
+	record.row = m_emptyArchetype->AddRow(entityID);
+	m_aliveEntityCount++;
+	return entityID;
+}
+
+void Resecs::ArchetypeWorld::Destroy(EntityID entity) {
+	auto& record = getRecord(entity);
+	record.archetype->DestructRow(record.row);
+	auto moved = record.archetype->EraseRow(record.row);
+	m_records[moved.index].row = record.row;
+	record.alive = false;
+	record.generation++;
+	m_freeIndices.push_back(entity.index);
+	m_aliveEntityCount--;
+}
+
+bool Resecs::ArchetypeWorld::CheckEntityAlive(EntityID toCheck) {
+	if (toCheck.index >= m_records.size()) {
+		return false;
+	}
+	auto& record = m_records[toCheck.index];
+	return record.alive && record.generation == toCheck.generation;
+}
+
+int Resecs::ArchetypeWorld::EntityCount() {
+	return m_aliveEntityCount;
+}
+
+size_t Resecs::ArchetypeWorld::ArchetypeCount() {
+	return m_archetypes.size();
+}
+
+ArchetypeWorld::EntityRecord & Resecs::ArchetypeWorld::getRecord(EntityID entity) {
+	if (!CheckEntityAlive(entity)) {
+		throw std::runtime_error("This entity is already destroyed!");
+	}
+	return m_records[entity.index];
+}
+
+Archetype * Resecs::ArchetypeWorld::getArchetype(const ComponentActivationBitset & signature) {
+	auto ite = m_archetypeBySignature.find(signature);
+	if (ite != m_archetypeBySignature.end())
+		return ite->second;
+	m_archetypes.emplace_back(NewWithResource<Archetype>(m_resource, signature, m_typeInfos, m_resource));
+	auto archetype = m_archetypes.back().get();
+	m_archetypeBySignature[signature] = archetype;
+	return archetype;
+}
+
+Archetype * Resecs::ArchetypeWorld::getArchetypeWith(Archetype * from, int componentIndex) {
+	auto ite = from->addEdges.find(componentIndex);
+	if (ite != from->addEdges.end())
+		return ite->second;
+	auto signature = from->GetSignature();
+	signature.set(componentIndex);
+	auto target = getArchetype(signature);
+	from->addEdges[componentIndex] = target;
+	target->removeEdges[componentIndex] = from;
+	return target;
+}
+
+Archetype * Resecs::ArchetypeWorld::getArchetypeWithout(Archetype * from, int componentIndex) {
+	auto ite = from->removeEdges.find(componentIndex);
+	if (ite != from->removeEdges.end())
+		return ite->second;
+	auto signature = from->GetSignature();
+	signature.reset(componentIndex);
+	auto target = getArchetype(signature);
+	from->removeEdges[componentIndex] = target;
+	target->addEdges[componentIndex] = from;
+	return target;
+}
+
+void Resecs::ArchetypeWorld::moveEntity(EntityID entity, Archetype * target, size_t newRow) {
+	auto& record = m_records[entity.index];
+	auto source = record.archetype;
+	auto& sourceColumns = source->GetColumns();
+	for (size_t i = 0; i < sourceColumns.size(); i++)
+	{
+		auto& info = sourceColumns[i].info;
+		auto targetColumn = target->GetColumn(sourceColumns[i].componentIndex);
+		if (targetColumn >= 0) {
+			info.moveConstruct(target->ComponentAt(newRow, targetColumn), source->ComponentAt(record.row, i));
+		}
+		info.destruct(source->ComponentAt(record.row, i));
+	}
+	auto moved = source->EraseRow(record.row);
+	m_records[moved.index].row = record.row;
+	record.archetype = target;
+	record.row = newRow;
+}
@@ -0,0 +1,178 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <unordered_map>
+#include <utility>
+#include <tuple>
+#include "EntityID.hpp"
+#include "Archetype.h"
+
+namespace Resecs {
+
+	/* Alternative storage backend to World.
+	Entities with the same set of components live together in an Archetype, adding or removing a component moves the entity to another archetype.
+	Each() matches archetypes instead of entities, and walks component columns of each chunk linearly, which suits queries with many components.
+	Changing components is more expensive than in World, since all components of the entity are moved.
+	Groups, events and singleton components are not supported, entities are referred to by EntityID.
+	Like World, everything is allocated from the given memory resource, e.g. an Arena.
+	*/
+	class ArchetypeWorld {
+	public:
+		explicit ArchetypeWorld(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+		ArchetypeWorld(const ArchetypeWorld& copy) = delete;
+		EntityID Create();
+		void Destroy(EntityID entity);
+		bool CheckEntityAlive(EntityID toCheck);
+		/* Current alive entities */
+		int EntityCount();
+		/* Count of archetypes created so far. */
+		size_t ArchetypeCount();
+		std::pmr::memory_resource* GetMemoryResource() const {
+			return m_resource;
+		}
+
+		/* Add a T to the entity.
+		Will throw exception if T already exists, or if the components of the entity don't fit in a chunk(see Archetype).
+		The entity is left unchanged if T throws while constructed.
+		*/
+		template<typename T>
+		T* Add(EntityID entity, T val) {
+			int compIndex = ConvertComponentTypeToIndex<T>();
+			auto& record = getRecord(entity);
+			if (record.archetype->GetColumn(compIndex) >= 0) {
+				throw std::runtime_error("This entity already has this component!");
+			}
+			auto target = getArchetypeWith(record.archetype, compIndex);
+			//construct T in the new row first, so a throw only has to drop the row.
+			auto row = target->AddRow(entity);
+			auto p = static_cast<T*>(target->ComponentAt(row, target->GetColumn(compIndex)));
+			try {
+				new (p) T(std::move(val));
+			}
+			catch (...) {
+				target->EraseRow(row);
+				throw;
+			}
+			moveEntity(entity, target, row);
+			return p;
+		}
+
+		template<typename T>
+		T* Add(EntityID entity) {
+			return Add<T>(entity, T());
+		}
+
+		/* Get pointer to T.
+		Will return nullptr if this component doesn't exist.
+		The pointer is invalidated by any structural change of the entity, or of another entity in the same archetype.
+		*/
+		template<typename T>
+		T* Get(EntityID entity) {
+			int compIndex = ConvertComponentTypeToIndex<T>();
+			auto& record = getRecord(entity);
+			auto column = record.archetype->GetColumn(compIndex);
+			if (column < 0)
+				return nullptr;
+			return static_cast<T*>(record.archetype->ComponentAt(record.row, column));
+		}
+
+		template<typename T>
+		bool Has(EntityID entity) {
+			int compIndex = ConvertComponentTypeToIndex<T>();
+			return getRecord(entity).archetype->GetColumn(compIndex) >= 0;
+		}
+
+		/* Remove a component form entity.
+		Throw exception if entity doesn't have T.
+		*/
+		template<typename T>
+		void Remove(EntityID entity) {
+			int compIndex = ConvertComponentTypeToIndex<T>();
+			auto& record = getRecord(entity);
+			if (record.archetype->GetColumn(compIndex) < 0) {
+				throw std::runtime_error("This entity doesn't have this type of component!");
+			}
+			auto target = getArchetypeWithout(record.archetype, compIndex);
+			moveEntity(entity, target, target->AddRow(entity));
+		}
+
+		/* Iterate all entities that has TComps, then do func(EntityID, TComps*...)
+		Entities can't be created, destroyed or changed during iteration.
+		*/
+		template<typename... TComps, typename TFunc>
+		void Each(TFunc func) {
+			auto componentFilter = ConvertComponentTypesToMask<TComps...>();
+			for (auto& archetype : m_archetypes) {
+				if (archetype->Count() == 0 || !archetype->GetSignature().Contains(componentFilter))
+					continue;
+				eachInArchetype<TComps...>(*archetype, func, std::index_sequence_for<TComps...>());
+			}
+		}
+
+		/* Same mapping as World: process-wide ComponentTypeID to a dense index in this ArchetypeWorld. */
+		template<typename T>
+		int ConvertComponentTypeToIndex() {
+			auto typeID = ComponentTypeID<T>();
+			if (typeID < m_componentIndexOfType.size() && m_componentIndexOfType[typeID] >= 0)
+				return m_componentIndexOfType[typeID];
+			if (m_typeInfos.size() >= MAX_COMPONENT_COUNT) {
+				throw std::overflow_error("Max component type count reached!!!");
+			}
+			m_typeInfos.push_back(ComponentTypeInfo::Of<T>());
+			int compIndex = m_typeInfos.size() - 1;
+			EnlargeVectorToFit(m_componentIndexOfType, typeID, -1);
+			m_componentIndexOfType[typeID] = compIndex;
+			return compIndex;
+		}
+		template<typename... TComps>
+		ComponentActivationBitset ConvertComponentTypesToMask() {
+			ComponentActivationBitset result;
+			int indices[] = { ConvertComponentTypeToIndex<TComps>()... };
+			for (auto index : indices) {
+				result.set(index);
+			}
+			return result;
+		}
+	private:
+		struct EntityRecord {
+			Archetype* archetype;
+			size_t row;
+			int generation;
+			bool alive;
+		};
+		EntityRecord& getRecord(EntityID entity);
+		Archetype* getArchetype(const ComponentActivationBitset& signature);
+		Archetype* getArchetypeWith(Archetype* from, int componentIndex);
+		Archetype* getArchetypeWithout(Archetype* from, int componentIndex);
+		/* Move entity into newRow of target, components target doesn't have are destructed.
+		Components only target has must have been constructed in newRow already.
+		*/
+		void moveEntity(EntityID entity, Archetype* target, size_t newRow);
+
+		template<typename... TComps, typename TFunc, size_t... Is>
+		void eachInArchetype(Archetype& archetype, TFunc& func, std::index_sequence<Is...>) {
+			int columns[] = { archetype.GetColumn(ConvertComponentTypeToIndex<TComps>())..., 0 };
+			for (size_t chunk = 0; chunk < archetype.ChunkCount(); chunk++)
+			{
+				auto entities = archetype.ChunkEntities(chunk);
+				auto columnPtrs = std::make_tuple(static_cast<TComps*>(archetype.ChunkColumn(chunk, columns[Is]))...);
+				auto rowCount = archetype.ChunkRowCount(chunk);
+				for (size_t i = 0; i < rowCount; i++)
+				{
+					func(entities[i], (std::get<Is>(columnPtrs) + i)...);
+				}
+			}
+		}
+
+		std::pmr::memory_resource* m_resource;
+		std::pmr::vector<EntityRecord> m_records{ m_resource };
+		std::pmr::vector<EntityIndex_t> m_freeIndices{ m_resource };
+		int m_aliveEntityCount = 0;
+		std::pmr::vector<int> m_componentIndexOfType{ m_resource };	//map ComponentTypeID to index, -1 if not registered.
+		std::pmr::vector<ComponentTypeInfo> m_typeInfos{ m_resource };
+		std::pmr::vector<ResourcePtr<Archetype>> m_archetypes{ m_resource };
+		std::pmr::unordered_map<ComponentActivationBitset, Archetype*> m_archetypeBySignature{ m_resource };
+		Archetype* m_emptyArchetype;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+#pragma once
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <cstdint>
+#include <algorithm>
+#include "World.h"
+#include "Utils\AlignedAllocator.hpp"
+
+namespace Resecs {
+
+	/* How a ForEachChunk term is passed: T as a const T* array, Mut<T> as a T* array whose components are marked as changed. */
+	template<typename T>
+	struct ChunkTerm {
+		using Component = T;
+		using Pointer = const T*;
+		const static bool IsMut = false;
+	};
+	template<typename T>
+	struct ChunkTerm<Mut<T>> {
+		using Component = T;
+		using Pointer = T*;
+		const static bool IsMut = true;
+	};
+
+	/* Splits entities having every component of TTerms into chunks of contiguous arrays, see World::ForEachChunk().
+	Entities are walked in the order of the smallest pool.
+	A run of entities that is contiguous in every pool and starts at a ChunkAlignment boundary in every pool is passed in place.
+	That's the case for members of an owning group, or entities created together by CreateMany().
+	Other entities are copied into aligned scratch buffers, Mut<T> ones are copied back after func returns.
+	Like in a View, only Mut<T> components get their change tick stamped and are recorded by a DeltaRecorder.
+	*/
+	template<typename... TTerms>
+	class ChunkQuery {
+		template<size_t I>
+		using Term = ChunkTerm<std::tuple_element_t<I, std::tuple<TTerms...>>>;
+		template<typename TTerm>
+		using ComponentOf = typename ChunkTerm<TTerm>::Component;
+		static_assert(sizeof...(TTerms) > 0, "ForEachChunk needs at least one component type");
+		static_assert(!(false || ... || IsSoAComponent<ComponentOf<TTerms>>::value), "SoA components have no TComp array, use Group::Column()");
+		static_assert(!(false || ... || IsPagedComponent<ComponentOf<TTerms>>::value), "Paged components have no TComp array, use Each()");
+	public:
+		/* Runs shorter than this are copied, calling func for a handful of entities would cost more than the copy. */
+		const static size_t MinInPlaceRun = 16;
+
+		ChunkQuery(World* world, size_t chunkSize) :
+			m_world(world),
+			m_chunkSize(chunkSize),
+			m_pools(world->getComponentManager<ComponentOf<TTerms>>()...) {
+			if (chunkSize == 0)
+				throw std::invalid_argument("chunkSize must be positive!");
+		}
+
+		template<typename TFunc>
+		void Run(TFunc& func) {
+			run(func, std::index_sequence_for<TTerms...>());
+		}
+	private:
+		template<typename T>
+		using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+		template<typename TFunc, size_t... Is>
+		void run(TFunc& func, std::index_sequence<Is...> indices) {
+			BaseComponentManager* candidates[] = { std::get<Is>(m_pools)... };
+			BaseComponentManager* driver = candidates[0];
+			for (auto candidate : candidates) {
+				if (candidate->Size() < driver->Size())
+					driver = candidate;
+			}
+			const int* entities = driver->Entities();
+			size_t size = driver->Size();
+			const int* poolEntities[] = { std::get<Is>(m_pools)->Entities()... };
+			size_t poolSizes[] = { std::get<Is>(m_pools)->Size()... };
+			size_t i = 0;
+			while (i < size) {
+				int index = entities[i];
+				if (!(std::get<Is>(m_pools)->Contains(index) && ...)) {
+					i++;
+					continue;
+				}
+				size_t positions[] = { static_cast<size_t>(std::get<Is>(m_pools)->IndexOf(index))... };
+				if ((isAligned(std::get<Is>(m_pools)->Data() + positions[Is]) && ...)) {
+					//extend the run while every pool holds the next entity right after the current one.
+					size_t length = 1;
+					size_t maxLength = std::min(size - i, m_chunkSize);
+					for (size_t k = 0; k < sizeof...(TTerms); k++)
+					{
+						maxLength = std::min(maxLength, poolSizes[k] - positions[k]);
+					}
+					while (length < maxLength && ((poolEntities[Is][positions[Is] + length] == entities[i + length]) && ...))
+						length++;
+					if (length >= MinInPlaceRun) {
+						flush(func, indices);
+						collectEntityIDs(entities + i, length);
+						func(length, m_entityIDs.data(), static_cast<typename Term<Is>::Pointer>(std::get<Is>(m_pools)->Data() + positions[Is])...);
+						(markWrittenAt<Term<Is>::IsMut>(std::get<Is>(m_pools), positions[Is], length), ...);
+						i += length;
+						continue;
+					}
+				}
+				m_batch.push_back(index);
+				if (m_batch.size() == m_chunkSize)
+					flush(func, indices);
+				i++;
+			}
+			flush(func, indices);
+		}
+
+		/* Copy batched entities to scratch buffers, call func, then copy Mut<T> ones back. */
+		template<typename TFunc, size_t... Is>
+		void flush(TFunc& func, std::index_sequence<Is...>) {
+			if (m_batch.empty())
+				return;
+			collectEntityIDs(m_batch.data(), m_batch.size());
+			(gather(std::get<Is>(m_pools), std::get<Is>(m_scratch)), ...);
+			func(m_batch.size(), m_entityIDs.data(), static_cast<typename Term<Is>::Pointer>(std::get<Is>(m_scratch).data())...);
+			(scatter<Term<Is>::IsMut>(std::get<Is>(m_pools), std::get<Is>(m_scratch)), ...);
+			m_batch.clear();
+		}
+		template<typename T>
+		void gather(ComponentManager<T>* pool, AlignedVector<T>& scratch) {
+			scratch.clear();
+			for (auto index : m_batch) {
+				scratch.push_back(*pool->Get(index));
+			}
+		}
+		template<bool IsMut, typename T>
+		void scatter(ComponentManager<T>* pool, AlignedVector<T>& scratch) {
+			if constexpr (!IsMut)
+				return;
+			for (size_t i = 0; i < m_batch.size(); i++)
+			{
+				*pool->GetMut(m_batch[i], m_world->m_changeTick) = std::move(scratch[i]);
+			}
+		}
+		template<bool IsMut, typename T>
+		void markWrittenAt(ComponentManager<T>* pool, size_t position, size_t count) {
+			if constexpr (IsMut)
+				pool->MarkWrittenAt(position, count, m_world->m_changeTick);
+		}
+		void collectEntityIDs(const int* indices, size_t count) {
+			m_entityIDs.clear();
+			for (size_t i = 0; i < count; i++)
+			{
+				m_entityIDs.push_back(m_world->m_entities[indices[i]]);
+			}
+		}
+
+		template<typename T>
+		static bool isAligned(const T* p) {
+			return reinterpret_cast<uintptr_t>(p) % ChunkAlignment == 0;
+		}
+
+		World* m_world;
+		size_t m_chunkSize;
+		std::tuple<ComponentManager<ComponentOf<TTerms>>*...> m_pools;
+		std::tuple<AlignedVector<ComponentOf<TTerms>>...> m_scratch;
+		std::vector<int> m_batch;	//entity indices waiting to be copied.
+		AlignedVector<EntityID> m_entityIDs;
+	};
+}
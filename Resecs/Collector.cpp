@@ -0,0 +1,75 @@
+#include "Collector.h"
+using namespace Resecs;
+
+Resecs::Collector::Collector(Group & group) :
+	m_entered(group.GetWorld()->GetMemoryResource()),
+	m_left(group.GetWorld()->GetMemoryResource()),
+	m_enteredPositions(group.GetWorld()->GetMemoryResource()),
+	m_leftPositions(group.GetWorld()->GetMemoryResource()),
+	//lambdas capturing this fit in the small buffer of std::function, a std::bind of a member function doesn't.
+	m_enteredConnection(group.OnEntityEntered.Connect([this](EntityID entity) { onEntered(entity); })),
+	m_leftConnection(group.OnEntityLeft.Connect([this](EntityID entity) { onLeft(entity); })) {}
+
+const std::pmr::vector<EntityID>& Resecs::Collector::Entered() const {
+	return m_entered;
+}
+
+const std::pmr::vector<EntityID>& Resecs::Collector::Left() const {
+	return m_left;
+}
+
+bool Resecs::Collector::Empty() const {
+	return m_entered.empty() && m_left.empty();
+}
+
+void Resecs::Collector::Drain(std::vector<EntityID>& entered, std::vector<EntityID>& left) {
+	//copy instead of swap, the lists live in the World's resource and the caller's don't. Capacities on both sides are kept.
+	entered.assign(m_entered.begin(), m_entered.end());
+	left.assign(m_left.begin(), m_left.end());
+	Clear();
+}
+
+void Resecs::Collector::Clear() {
+	for (auto entity : m_entered) {
+		m_enteredPositions[entity.index] = -1;
+	}
+	for (auto entity : m_left) {
+		m_leftPositions[entity.index] = -1;
+	}
+	m_entered.clear();
+	m_left.clear();
+}
+
+void Resecs::Collector::onEntered(EntityID entity) {
+	//left then entered again, nothing changed.
+	if (contains(m_left, m_leftPositions, entity))
+		erase(m_left, m_leftPositions, entity);
+	else
+		push(m_entered, m_enteredPositions, entity);
+}
+
+void Resecs::Collector::onLeft(EntityID entity) {
+	//entered then left, nothing changed.
+	if (contains(m_entered, m_enteredPositions, entity))
+		erase(m_entered, m_enteredPositions, entity);
+	else
+		push(m_left, m_leftPositions, entity);
+}
+
+void Resecs::Collector::push(std::pmr::vector<EntityID>& list, std::pmr::vector<int>& positions, EntityID entity) {
+	EnlargeVectorToFit(positions, entity.index, -1);
+	positions[entity.index] = list.size();
+	list.push_back(entity);
+}
+
+void Resecs::Collector::erase(std::pmr::vector<EntityID>& list, std::pmr::vector<int>& positions, EntityID entity) {
+	auto position = positions[entity.index];
+	list[position] = list.back();
+	positions[list[position].index] = position;
+	list.pop_back();
+	positions[entity.index] = -1;
+}
+
+bool Resecs::Collector::contains(const std::pmr::vector<EntityID>& list, const std::pmr::vector<int>& positions, EntityID entity) {
+	return entity.index < positions.size() && positions[entity.index] >= 0 && list[positions[entity.index]] == entity;
+}
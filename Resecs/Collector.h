@@ -0,0 +1,45 @@
+#pragma once
+#include <vector>
+#include <memory_resource>
+#include "Group.h"
+
+namespace Resecs {
+
+	/* Collects entities entering and leaving a Group, so a system can process them in one pass per frame.
+	Lists hold the net change since the last Drain():
+	an entity that enters then leaves(or leaves then enters) is in neither list, and every entity is listed once.
+	Members of the group when the collector is created are not collected.
+	Lists allocate from the memory resource of the World.
+	*/
+	class Collector {
+	public:
+		Collector(Group& group);
+		Collector(const Collector& copy) = delete;
+
+		/* Entities that entered the group since the last Drain() and are still inside. */
+		const std::pmr::vector<EntityID>& Entered() const;
+		/* Entities that were in the group at the last Drain() and have left, they may have been destroyed. */
+		const std::pmr::vector<EntityID>& Left() const;
+		bool Empty() const;
+
+		/* Copy collected entities into entered/left(their old content is discarded), and start collecting again.
+		Since the lists are copied out, it's safe to change the World while processing them.
+		*/
+		void Drain(std::vector<EntityID>& entered, std::vector<EntityID>& left);
+		void Clear();
+	private:
+		void onEntered(EntityID entity);
+		void onLeft(EntityID entity);
+		/* Append/remove entity in list, positions maps entity index to the position in list. */
+		static void push(std::pmr::vector<EntityID>& list, std::pmr::vector<int>& positions, EntityID entity);
+		static void erase(std::pmr::vector<EntityID>& list, std::pmr::vector<int>& positions, EntityID entity);
+		static bool contains(const std::pmr::vector<EntityID>& list, const std::pmr::vector<int>& positions, EntityID entity);
+
+		std::pmr::vector<EntityID> m_entered;
+		std::pmr::vector<EntityID> m_left;
+		std::pmr::vector<int> m_enteredPositions;
+		std::pmr::vector<int> m_leftPositions;
+		GroupEventDelegate::SignalConnection m_enteredConnection;
+		GroupEventDelegate::SignalConnection m_leftConnection;
+	};
+}
@@ -0,0 +1,167 @@
+#include "CommandBuffer.h"
+#include <algorithm>
+using namespace Resecs;
+
+Resecs::CommandBuffer::CommandBuffer(World * world, std::pmr::memory_resource* resource) :
+	m_world(world),
+	m_resource(resource != nullptr ? resource : world->GetMemoryResource()) {}
+
+EntityID Resecs::CommandBuffer::Create() {
+	return EntityID(m_pendingCreateCount++, PendingGeneration);
+}
+
+void Resecs::CommandBuffer::Destroy(EntityID entity) {
+	m_destroyed.push_back(entity);
+}
+
+void Resecs::CommandBuffer::Playback() {
+	try {
+		playbackCreate();
+		std::vector<std::pair<int, BaseCommandQueue*>> queues;
+		collectQueues(queues);
+		for (auto& queue : queues) {
+			queue.second->Playback(*this);
+		}
+		playbackDestroy();
+	}
+	catch (...) {
+		//placeholders of the remaining commands would mean nothing to the next playback.
+		clear();
+		throw;
+	}
+}
+
+bool Resecs::CommandBuffer::Empty() {
+	if (m_pendingCreateCount > 0 || m_destroyed.size() > 0)
+		return false;
+	for (auto& queue : m_queues) {
+		if (!queue.second->Empty())
+			return false;
+	}
+	return true;
+}
+
+EntityID Resecs::CommandBuffer::resolve(EntityID entity) {
+	if (entity.generation == PendingGeneration)
+		return m_created[entity.index];
+	return entity;
+}
+
+void Resecs::CommandBuffer::playbackCreate() {
+	m_created.clear();
+	auto count = m_pendingCreateCount;
+	m_pendingCreateCount = 0;
+	if (count == 0)
+		return;
+	std::vector<Entity> entities;
+	std::pmr::vector<int> indices(m_resource);
+	m_world->createEntities(count, entities, indices);
+	for (auto& entity : entities) {
+		m_created.push_back(entity.entityID);
+	}
+}
+
+/* Append non-empty queues, sorted by component type index. */
+void Resecs::CommandBuffer::collectQueues(std::vector<std::pair<int, BaseCommandQueue*>>& queues) {
+	for (auto& queue : m_queues) {
+		if (!queue.second->Empty())
+			queues.push_back(std::make_pair(queue.second->GetComponentIndex(*m_world), queue.second.get()));
+	}
+	std::stable_sort(queues.begin(), queues.end(), [](auto& a, auto& b) {
+		return a.first < b.first;
+	});
+}
+
+void Resecs::CommandBuffer::playbackDestroy() {
+	std::pmr::vector<EntityID> destroyed(m_resource);
+	destroyed.swap(m_destroyed);
+	for (auto& entity : destroyed) {
+		auto resolved = resolve(entity);
+		if (m_world->CheckEntityAlive(resolved))
+			m_world->GetEntityHandle(resolved).Destroy();
+	}
+	//keep the capacity, unless listeners recorded new destroys meanwhile.
+	if (m_destroyed.empty()) {
+		destroyed.clear();
+		m_destroyed.swap(destroyed);
+	}
+}
+
+void Resecs::CommandBuffer::flush() {
+	if (m_batch.empty())
+		return;
+	//listeners may record into this buffer, so the batch is taken out first.
+	std::pmr::vector<ComponentEventArgs> batch(m_resource);
+	batch.swap(m_batch);
+	m_world->notifyComponentsChanged(batch);
+	if (m_batchRemoves) {
+		for (auto& arg : batch) {
+			m_world->getComponentManager(arg.componentTypeIndex)->Release(arg.entity.index);
+		}
+	}
+	batch.clear();
+	m_batch.swap(batch);
+}
+
+void Resecs::CommandBuffer::clear() {
+	m_pendingCreateCount = 0;
+	m_destroyed.clear();
+	for (auto& queue : m_queues) {
+		queue.second->Clear();
+	}
+}
+
+Resecs::ThreadCommandBuffers::ThreadCommandBuffers(World * world) : m_world(world) {}
+
+CommandBuffer & Resecs::ThreadCommandBuffers::Local() {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto& buffer = m_bufferOfThread[std::this_thread::get_id()];
+	if (buffer == nullptr) {
+		m_buffers.emplace_back(std::make_unique<CommandBuffer>(m_world, std::pmr::get_default_resource()));
+		buffer = m_buffers.back().get();
+	}
+	return *buffer;
+}
+
+void Resecs::ThreadCommandBuffers::Playback() {
+	try {
+		playback();
+	}
+	catch (...) {
+		for (auto& buffer : m_buffers) {
+			buffer->clear();
+		}
+		throw;
+	}
+}
+
+void Resecs::ThreadCommandBuffers::playback() {
+	for (auto& buffer : m_buffers) {
+		buffer->playbackCreate();
+	}
+	//each queue keeps its buffer, since placeholders are resolved per buffer.
+	std::vector<std::pair<int, CommandBuffer::BaseCommandQueue*>> queues;
+	std::vector<CommandBuffer*> owners;
+	for (auto& buffer : m_buffers) {
+		std::vector<std::pair<int, CommandBuffer::BaseCommandQueue*>> bufferQueues;
+		buffer->collectQueues(bufferQueues);
+		for (auto& queue : bufferQueues) {
+			queues.push_back(queue);
+			owners.push_back(buffer.get());
+		}
+	}
+	std::vector<size_t> order(queues.size());
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+		return queues[a].first < queues[b].first;
+	});
+	for (auto i : order) {
+		queues[i].second->Playback(*owners[i]);
+	}
+	for (auto& buffer : m_buffers) {
+		buffer->playbackDestroy();
+	}
+}
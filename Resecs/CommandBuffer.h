@@ -0,0 +1,227 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <typeindex>
+#include "World.h"
+
+namespace Resecs {
+
+	/* Records structural changes and plays them back later at a sync point.
+	Use it to create/destroy entities or add/remove components while iterating a Group, a View, or inside ParallelEach.
+	Recording doesn't touch the World, so different threads can record into different buffers(see ThreadCommandBuffers).
+
+	Playback order is: all Create, then commands of each component type in type index order, then all Destroy.
+	Commands of a type are applied in bulk: consecutive adds/replaces(or removes) fire their events as one batch, like CreateMany().
+	Commands on an entity that is dead at playback are skipped.
+	A command that fails(e.g. Add of a component the entity already has) throws out of Playback(), the rest of the buffer is dropped.
+	*/
+	class CommandBuffer {
+	public:
+		/* Commands are stored in resource, nullptr means the memory resource of world. */
+		CommandBuffer(World* world, std::pmr::memory_resource* resource = nullptr);
+		CommandBuffer(const CommandBuffer& copy) = delete;
+
+		/* Record creation of an entity.
+		The returned EntityID is a placeholder that can only be passed to this buffer, it's replaced with the real entity on playback.
+		*/
+		EntityID Create();
+		void Destroy(EntityID entity);
+
+		template<typename T>
+		void Add(EntityID entity, T val) {
+			getQueue<T>().Record(CommandType::Add, entity, std::move(val));
+		}
+		template<typename T>
+		void Add(EntityID entity) {
+			Add<T>(entity, T());
+		}
+		template<typename T>
+		void Remove(EntityID entity) {
+			getQueue<T>().Record(CommandType::Remove, entity);
+		}
+		/* Same as Entity::Replace, do Add only if entity doesn't have T. */
+		template<typename T>
+		void Replace(EntityID entity, T val) {
+			getQueue<T>().Record(CommandType::Replace, entity, std::move(val));
+		}
+
+		/* Execute all recorded commands, the buffer is empty afterwards even if a command throws. */
+		void Playback();
+		bool Empty();
+	private:
+		friend class ThreadCommandBuffers;
+		enum class CommandType {
+			Add,
+			Remove,
+			Replace,
+		};
+		const static int PendingGeneration = -1;
+
+		/* Commands on one component type. */
+		class BaseCommandQueue {
+		public:
+			virtual ~BaseCommandQueue() {}
+			virtual int GetComponentIndex(World& world) = 0;
+			virtual void Playback(CommandBuffer& buffer) = 0;
+			virtual bool Empty() = 0;
+			virtual void Clear() = 0;
+		};
+		template<typename T>
+		class CommandQueue : public BaseCommandQueue {
+		public:
+			CommandQueue(std::pmr::memory_resource* resource) : commands(resource), values(resource) {}
+			void Record(CommandType type, EntityID entity) {
+				commands.push_back(Command{ type, entity, 0 });
+			}
+			void Record(CommandType type, EntityID entity, T val) {
+				commands.push_back(Command{ type, entity, values.size() });
+				values.push_back(std::move(val));
+			}
+			virtual int GetComponentIndex(World& world) override {
+				return world.ConvertComponentTypeToIndex<T>();
+			}
+			virtual void Playback(CommandBuffer& buffer) override {
+				auto& world = *buffer.m_world;
+				//take the commands out first, so they are gone even if one of them throws.
+				std::pmr::vector<Command> pendingCommands(commands.get_allocator().resource());
+				std::pmr::vector<T> pendingValues(values.get_allocator().resource());
+				pendingCommands.swap(commands);
+				pendingValues.swap(values);
+				//grow the pool once for all adds.
+				size_t addCount = 0;
+				for (auto& command : pendingCommands) {
+					if (command.type != CommandType::Remove)
+						addCount++;
+				}
+				reserve<T>(world, addCount);
+
+				try {
+					for (auto& command : pendingCommands) {
+						EntityID entity = buffer.resolve(command.entity);
+						if (!world.CheckEntityAlive(entity))
+							continue;
+						buffer.apply<T>(command.type, entity, command.type == CommandType::Remove ? nullptr : &pendingValues[command.valueIndex]);
+					}
+				}
+				catch (...) {
+					//components applied so far still get their events.
+					buffer.flush();
+					throw;
+				}
+				buffer.flush();
+				//keep the capacity for the next frame, unless listeners recorded new commands meanwhile.
+				if (commands.empty()) {
+					pendingCommands.clear();
+					pendingValues.clear();
+					commands.swap(pendingCommands);
+					values.swap(pendingValues);
+				}
+			}
+			virtual bool Empty() override {
+				return commands.empty();
+			}
+			virtual void Clear() override {
+				commands.clear();
+				values.clear();
+			}
+		private:
+			struct Command {
+				CommandType type;
+				EntityID entity;
+				size_t valueIndex;	//position in values, Remove doesn't have a value.
+			};
+			std::pmr::vector<Command> commands;
+			std::pmr::vector<T> values;
+		};
+
+		template<typename T>
+		static void reserve(World& world, size_t count) {
+			world.getComponentManager<T>()->Reserve(count);
+		}
+		/* Apply one command to an alive entity, its event joins the pending batch, see flush().
+		Adds/replaces and removes don't share a batch: removed components stay in the pool until their events are fired.
+		*/
+		template<typename T>
+		void apply(CommandType type, EntityID entity, T* value) {
+			auto& world = *m_world;
+			int compIndex = world.ConvertComponentTypeToIndex<T>();
+			bool removing = type == CommandType::Remove;
+			if (removing != m_batchRemoves) {
+				flush();
+				m_batchRemoves = removing;
+			}
+			bool has = world.getComponentActivationStatus(entity, compIndex);
+			auto pool = world.getComponentManager<T>();
+			if (removing) {
+				if (!has)
+					throw std::runtime_error("This entity doesn't have this type of component!");
+				world.setComponentActivationStatus(entity, compIndex, false);
+				m_batch.push_back(ComponentEventArgs(ComponentEventType::Removed, entity, compIndex));
+			}
+			else if (!has) {
+				pool->Emplace(entity.index, world.m_changeTick, std::move(*value));
+				world.setComponentActivationStatus(entity, compIndex, true);
+				m_batch.push_back(ComponentEventArgs(ComponentEventType::Added, entity, compIndex));
+			}
+			else if (type == CommandType::Replace) {
+				*pool->GetMut(entity.index, world.m_changeTick) = std::move(*value);
+				m_batch.push_back(ComponentEventArgs(ComponentEventType::Updated, entity, compIndex));
+			}
+			else
+			{
+				throw std::runtime_error("This entity already has this component!");
+			}
+		}
+		/* Fire the events of the pending batch at once, then release the removed components. */
+		void flush();
+		/* Drop everything recorded. */
+		void clear();
+		template<typename T>
+		CommandQueue<T>& getQueue() {
+			auto& queue = m_queues[typeid(T)];
+			if (queue == nullptr)
+				queue = NewWithResource<CommandQueue<T>, BaseCommandQueue>(m_resource, m_resource);
+			return static_cast<CommandQueue<T>&>(*queue);
+		}
+		/* Map placeholder from Create() to the created entity. */
+		EntityID resolve(EntityID entity);
+
+		/* Playback is split into steps so ThreadCommandBuffers can interleave several buffers. */
+		void playbackCreate();
+		void collectQueues(std::vector<std::pair<int, BaseCommandQueue*>>& queues);
+		void playbackDestroy();
+
+		World* m_world;
+		std::pmr::memory_resource* m_resource;
+		size_t m_pendingCreateCount = 0;
+		std::pmr::vector<EntityID> m_created{ m_resource };
+		std::pmr::vector<EntityID> m_destroyed{ m_resource };
+		std::pmr::unordered_map<std::type_index, ResourcePtr<BaseCommandQueue>> m_queues{ m_resource };
+		std::pmr::vector<ComponentEventArgs> m_batch{ m_resource };	//events of the commands applied since the last flush().
+		bool m_batchRemoves = false;	//whether m_batch holds removes.
+	};
+
+	/* One CommandBuffer per thread, played back together.
+	Call Local() once per task(e.g. at the start of a ParallelEach range), and Playback() from one thread after all tasks are done.
+	Threads record at the same time, so the buffers use the thread safe std::pmr::get_default_resource() rather than the World's resource.
+	*/
+	class ThreadCommandBuffers {
+	public:
+		ThreadCommandBuffers(World* world);
+		ThreadCommandBuffers(const ThreadCommandBuffers& copy) = delete;
+		/* Buffer of the calling thread. */
+		CommandBuffer& Local();
+		/* Play back all buffers, component commands of all buffers are still grouped by type. All buffers are empty afterwards, even if a command throws. */
+		void Playback();
+	private:
+		void playback();
+		World* m_world;
+		std::mutex m_mutex;
+		std::unordered_map<std::thread::id, CommandBuffer*> m_bufferOfThread;
+		std::vector<std::unique_ptr<CommandBuffer>> m_buffers;
+	};
+}
\ No newline at end of file
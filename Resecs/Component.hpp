@@ -1,4 +1,6 @@
 #pragma once
+#include <atomic>
+#include <cstddef>
 
 namespace Resecs {
 	class Component{
@@ -7,4 +9,17 @@ namespace Resecs {
 	class ISingletonComponent {
 
 	};
+
+	inline size_t NextComponentTypeID() {
+		static std::atomic<size_t> counter(0);
+		return counter++;
+	}
+	/* Process-wide ID of component type T, assigned on first use.
+	IDs are shared by all Worlds, each World maps them to its own dense component index(see World::ConvertComponentTypeToIndex()).
+	*/
+	template<typename T>
+	size_t ComponentTypeID() {
+		static const size_t id = NextComponentTypeID();
+		return id;
+	}
 }
\ No newline at end of file
@@ -1,69 +1,387 @@
 #pragma once
 #include <vector>
-#include <queue>
+#include <memory_resource>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include <typeinfo>
+#include <stdexcept>
+#include <type_traits>
 #include "Utils\Common.hpp"
+#include "Utils\SoA.hpp"
+
+/* World change ticks when a component was added and last written, see World::IncrementChangeTick().
+Ticks are compared with wrap-around, so a tick is only meaningful for 2^31 increments.
+*/
+struct ComponentTicks {
+	uint32_t added;
+	uint32_t changed;
+	bool AddedSince(uint32_t since) const {
+		return static_cast<int32_t>(added - since) > 0;
+	}
+	bool ChangedSince(uint32_t since) const {
+		return static_cast<int32_t>(changed - since) > 0;
+	}
+};
 
 class BaseComponentManager
 {
 public:
 	virtual void Release(int id) = 0;
-	virtual void Create(int id) = 0;
+	/* Create a component for id at the given change tick. */
+	virtual void Create(int id, uint32_t tick) = 0;
+	virtual bool Contains(int id) const = 0;
+	/* Count of live components. */
+	virtual size_t Size() const = 0;
+	/* Entity index owning each live component. */
+	virtual const int* Entities() const = 0;
+	/* Position of the component of id in the packed arrays, -1 if there's none. */
+	virtual int IndexOf(int id) const = 0;
+	/* Swap two components in the packed arrays. */
+	virtual void Swap(size_t a, size_t b) = 0;
+	/* Count of components the packed arrays hold without reallocation. */
+	virtual size_t Capacity() const = 0;
+	/* Length of the entity index to position map, which grows to the largest entity index seen. */
+	virtual size_t IndexSize() const = 0;
+	/* Name of the component type, as given by typeid. */
+	virtual const char* TypeName() const = 0;
+	/* Release spare capacity, and trim the entity index map to the largest entity index holding a component. */
+	virtual void Shrink() = 0;
+	/* Reorder the packed arrays by entity index, so iterating several pools walks them in the same order. */
+	virtual void SortByEntity() = 0;
 	virtual ~BaseComponentManager()
 	{
 
 	}
+
+	/* The owning group that decides the order of this pool, see Group::CreateOwningGroup(). */
+	const void* GetOwner() const {
+		return m_owner;
+	}
+	void SetOwner(const void* owner) {
+		m_owner = owner;
+	}
+	/* Changes whenever Entities() or Size() may have changed(components created or released, arrays reallocated).
+	A loop over Entities() compares it once per step to know when to read them again, see View.
+	*/
+	uint32_t GetVersion() const {
+		return m_version;
+	}
+protected:
+	void bumpVersion() {
+		m_version++;
+	}
+private:
+	const void* m_owner = nullptr;
+	uint32_t m_version = 0;
 };
 
+/* Component storage, implemented as a sparse set.
+Live components are kept packed at the front of m_componentPool, m_entities holds the owner of each of them at the same position.
+m_componentIndex maps entity index to the position in the packed arrays.
+Releasing a component moves the last one into the hole, so the pool never contains dead slots.
+Components declaring a SoALayout are stored as one array per field(see SoA.hpp), Get() then returns a SoAPointer instead of TComp*.
+Components declaring Paging are stored in pages(see Paged.hpp), only their positions are packed, so releasing or swapping never moves a component.
+*/
 template <typename TComp>
-class ComponentManager : public BaseComponentManager {
+class ComponentManager final : public BaseComponentManager {
 public:
-	ComponentManager(size_t initialSize = 1024):
-		m_componentIndex(initialSize),
-		m_componentPool(initialSize)
-	{
+	const static int InvalidIndex = -1;
+	const static bool IsSoA = Resecs::IsSoAComponent<TComp>::value;
+	const static bool IsPaged = Resecs::IsPagedComponent<TComp>::value;
+	using Pointer = Resecs::ComponentPointer<TComp>;
 
+	/* Every array of the pool allocates from resource, see World::World(). */
+	ComponentManager(size_t initialSize = 1024, std::pmr::memory_resource* resource = std::pmr::get_default_resource()):
+		m_componentPool(resource),
+		m_entities(resource),
+		m_ticks(resource),
+		m_componentIndex(initialSize, static_cast<int>(InvalidIndex), resource),
+		m_changedIDs(resource),
+		m_changedMark(resource)
+	{
+		m_componentPool.reserve(initialSize);
+		m_entities.reserve(initialSize);
+		m_ticks.reserve(initialSize);
 	}
 
 	//GetComponent a component for id.
-	TComp* Get(int id) {
-		if (id >= m_componentIndex.size())
+	Pointer Get(int id) {
+		if (!Contains(id))
+			return nullptr;
+		return At(m_componentIndex[id]);
+	}
+
+	/* Same as Get(), but mark the component as changed at tick. */
+	Pointer GetMut(int id, uint32_t tick) {
+		auto p = GetMutConcurrent(id, tick);
+		if (p != nullptr)
+			MarkChanged(id);
+		return p;
+	}
+
+	/* Same as GetMut(), but id isn't recorded for TakeChangedIDs(), so several threads may call it for distinct ids.
+	The caller records the ids with MarkChanged() from one thread afterwards, see View::ParallelEach().
+	*/
+	Pointer GetMutConcurrent(int id, uint32_t tick) {
+		if (!Contains(id))
 			return nullptr;
 		auto memoryIndex = m_componentIndex[id];
-		return &m_componentPool[memoryIndex];
+		m_ticks[memoryIndex].changed = tick;
+		return At(memoryIndex);
+	}
+
+	/* Same as GetMut() on the count components stored from position on, see ChunkQuery. */
+	void MarkWrittenAt(size_t position, size_t count, uint32_t tick) {
+		for (size_t i = position; i < position + count; i++)
+		{
+			m_ticks[i].changed = tick;
+		}
+		if (m_trackChanges) {
+			for (size_t i = position; i < position + count; i++)
+			{
+				markChanged(m_entities[i]);
+			}
+		}
+	}
+
+	/* Record id for TakeChangedIDs() if changes are tracked. Not thread safe. */
+	void MarkChanged(int id) {
+		if (m_trackChanges)
+			markChanged(id);
+	}
+
+	/* Start/stop recording ids passed to GetMut(), see TakeChangedIDs(). Used by DeltaRecorder. */
+	void TrackChanges(bool enabled) {
+		m_trackChanges = enabled;
+		m_changedIDs.clear();
+		m_changedMark.clear();
+	}
+	bool IsTrackingChanges() const {
+		return m_trackChanges;
+	}
+	/* Replace ids with the ids written through GetMut() since the last call, each of them once.
+	Ids may have lost the component since.
+	*/
+	void TakeChangedIDs(std::pmr::vector<int>& ids) {
+		for (auto id : m_changedIDs) {
+			m_changedMark[id] = 0;
+		}
+		ids.assign(m_changedIDs.begin(), m_changedIDs.end());
+		m_changedIDs.clear();
+	}
+
+	/* Component at position in the packed arrays. */
+	Pointer At(size_t position) {
+		if constexpr (IsSoA)
+			return Pointer(&m_componentPool, position);
+		else
+			return &m_componentPool[position];
+	}
+
+	/* Ticks of the component of id, which must exist. */
+	const ComponentTicks& GetTicks(int id) const {
+		return m_ticks[m_componentIndex[id]];
+	}
+
+	virtual int IndexOf(int id) const override {
+		if (!Contains(id))
+			return InvalidIndex;
+		return m_componentIndex[id];
 	}
-	
+
+	virtual void Swap(size_t a, size_t b) override {
+		if (a == b)
+			return;
+		if constexpr (IsSoA || IsPaged)
+			m_componentPool.Swap(a, b);
+		else
+			std::swap(m_componentPool[a], m_componentPool[b]);
+		std::swap(m_entities[a], m_entities[b]);
+		std::swap(m_ticks[a], m_ticks[b]);
+		m_componentIndex[m_entities[a]] = a;
+		m_componentIndex[m_entities[b]] = b;
+	}
+
+	virtual bool Contains(int id) const override {
+		return static_cast<size_t>(id) < m_componentIndex.size() && m_componentIndex[id] != InvalidIndex;
+	}
+
 	//release a component for id.
 	virtual void Release(int id) override {
 		auto memoryIndex = m_componentIndex[id];
-		m_releasedIndex.push(memoryIndex);
+		auto lastIndex = static_cast<int>(m_componentPool.size()) - 1;
+		if (memoryIndex != lastIndex) {
+			//move the last component into the hole.
+			if constexpr (IsSoA || IsPaged)
+				m_componentPool.Move(memoryIndex, lastIndex);
+			else
+				m_componentPool[memoryIndex] = std::move(m_componentPool[lastIndex]);
+			m_entities[memoryIndex] = m_entities[lastIndex];
+			m_ticks[memoryIndex] = m_ticks[lastIndex];
+			m_componentIndex[m_entities[memoryIndex]] = memoryIndex;
+		}
+		m_componentPool.pop_back();
+		m_entities.pop_back();
+		m_ticks.pop_back();
+		m_componentIndex[id] = InvalidIndex;
+		bumpVersion();
 	}
 
 	//create a component for id.
-	virtual void Create(int id) override {
-		int memoryIndex;
-		if (m_releasedIndex.size() > 0) {
-			//use released index.
-			memoryIndex = m_releasedIndex.front();
-			m_releasedIndex.pop();
-		}
+	virtual void Create(int id, uint32_t tick) override {
+		Emplace(id, tick);
+	}
+
+	/* Create the component of id at the given change tick, constructed in place from args.
+	Aggregates without a matching constructor are brace-initialized from args, then moved in.
+	*/
+	template<typename... TArgs>
+	void Emplace(int id, uint32_t tick, TArgs&&... args) {
+		//enlarge index pool.
+		Resecs::EnlargeVectorToFit(m_componentIndex, id, InvalidIndex);
+
+		//append to the packed arrays.
+		if constexpr (std::is_constructible<TComp, TArgs...>::value)
+			m_componentPool.emplace_back(std::forward<TArgs>(args)...);
 		else
+			m_componentPool.emplace_back(TComp{ std::forward<TArgs>(args)... });
+		m_componentIndex[id] = static_cast<int>(m_componentPool.size()) - 1;
+		m_entities.push_back(id);
+		m_ticks.push_back(ComponentTicks{ tick, tick });
+		bumpVersion();
+	}
+
+	/* Create a copy of value for each of count ids, none of them may have the component yet.
+	The packed arrays grow once, instead of once per component.
+	*/
+	void CreateMany(const int* ids, size_t count, const TComp& value, uint32_t tick) {
+		if (count == 0)
+			return;
+		Resecs::EnlargeVectorToFit(m_componentIndex, *std::max_element(ids, ids + count), InvalidIndex);
+		auto begin = m_componentPool.size();
+		m_componentPool.resize(begin + count, value);
+		m_entities.insert(m_entities.end(), ids, ids + count);
+		m_ticks.resize(begin + count, ComponentTicks{ tick, tick });
+		bumpVersion();
+		for (size_t i = 0; i < count; i++)
 		{
-			//use a new slot.
-			memoryIndex = m_maxIndex++;
-			//enlarge pool.
-			EnlargeVectorToFit(m_componentPool, memoryIndex);
+			m_componentIndex[ids[i]] = static_cast<int>(begin + i);
 		}
+	}
 
-		//enlarge index pool.
-		EnlargeVectorToFit(m_componentIndex, memoryIndex);
+	/* Replace the content of an empty pool with count components of ids, copied as whole arrays.
+	Used to load snapshots, see Snapshot.h.
+	*/
+	void Assign(const int* ids, const ComponentTicks* ticks, const TComp* components, size_t count) {
+		static_assert(!IsSoA && !IsPaged, "Assign() takes array-of-structs components");
+		if (Size() != 0)
+			throw std::runtime_error("Assign() needs an empty pool!");
+		m_componentPool.assign(components, components + count);
+		m_entities.assign(ids, ids + count);
+		m_ticks.assign(ticks, ticks + count);
+		bumpVersion();
+		if (count > 0) {
+			size_t maxID = *std::max_element(ids, ids + count);
+			if (maxID >= m_componentIndex.size())
+				m_componentIndex.resize(maxID + 1, static_cast<int>(InvalidIndex));
+		}
+		for (size_t i = 0; i < count; i++)
+		{
+			m_componentIndex[ids[i]] = static_cast<int>(i);
+		}
+	}
 
-		//map index to correct memory position.
-		m_componentIndex[id] = memoryIndex;
+	/* Make room for count more components, so they can be created without reallocation. */
+	void Reserve(size_t count) {
+		m_componentPool.reserve(m_componentPool.size() + count);
+		m_entities.reserve(m_entities.size() + count);
+		m_ticks.reserve(m_ticks.size() + count);
+		bumpVersion();
+	}
+
+	virtual size_t Size() const override {
+		return m_componentPool.size();
+	}
+	virtual size_t Capacity() const override {
+		return m_componentPool.capacity();
+	}
+	virtual size_t IndexSize() const override {
+		return m_componentIndex.size();
+	}
+	virtual const char* TypeName() const override {
+		return typeid(TComp).name();
+	}
+
+	/* Packed components, Size() of them are alive. Not available for SoA components(use Column() instead) and paged components. */
+	TComp* Data() {
+		static_assert(!IsSoA, "SoA components are not stored as TComp, use Column()");
+		static_assert(!IsPaged, "Paged components are not stored as one array");
+		return m_componentPool.data();
+	}
+
+	/* Packed array of field Member of a SoA component, in the same order as Entities(). */
+	template<auto Member>
+	auto Column() {
+		static_assert(IsSoA, "Column() is only available for SoA components");
+		return m_componentPool.template Column<Member>();
+	}
+
+	virtual void Shrink() override {
+		int maxID = -1;
+		for (auto id : m_entities) {
+			maxID = std::max(maxID, id);
+		}
+		m_componentIndex.resize(maxID + 1);
+		m_componentIndex.shrink_to_fit();
+		m_componentPool.shrink_to_fit();
+		m_entities.shrink_to_fit();
+		m_ticks.shrink_to_fit();
+		bumpVersion();
+		//ids waiting in m_changedIDs must keep their mark.
+		for (auto id : m_changedIDs) {
+			maxID = std::max(maxID, id);
+		}
+		m_changedMark.resize(std::min(m_changedMark.size(), static_cast<size_t>(maxID + 1)));
+		m_changedMark.shrink_to_fit();
+	}
+
+	virtual void SortByEntity() override {
+		if (std::is_sorted(m_entities.begin(), m_entities.end()))
+			return;
+		std::pmr::vector<int> sorted(m_entities.begin(), m_entities.end(), m_entities.get_allocator());
+		std::sort(sorted.begin(), sorted.end());
+		//positions before i are final, so every swap moves one more component to its place.
+		for (size_t i = 0; i < sorted.size(); i++)
+		{
+			Swap(i, m_componentIndex[sorted[i]]);
+		}
+	}
+
+	/* Ticks of the components, in the same order as Entities(). */
+	const ComponentTicks* Ticks() const {
+		return m_ticks.data();
+	}
+
+	/* Entity index owning the component at the same position of Data(). */
+	virtual const int* Entities() const override {
+		return m_entities.data();
 	}
 
 private:
-	int m_maxIndex = 0;
-	std::vector<TComp> m_componentPool;	//map 
-	std::vector<int> m_componentIndex;	//map entity ID to actual component id.
-	std::queue<int> m_releasedIndex; //indexes that were released but not used yet.
+	void markChanged(int id) {
+		Resecs::EnlargeVectorToFit(m_changedMark, id, uint8_t(0));
+		if (m_changedMark[id])
+			return;
+		m_changedMark[id] = 1;
+		m_changedIDs.push_back(id);
+	}
+
+	typename Resecs::ComponentStorage<TComp>::Type m_componentPool;	//packed live components.
+	std::pmr::vector<int> m_entities;	//map position in m_componentPool to entity index.
+	std::pmr::vector<ComponentTicks> m_ticks;	//ticks of the component at the same position.
+	std::pmr::vector<int> m_componentIndex;	//map entity ID to actual component id.
+	bool m_trackChanges = false;
+	std::pmr::vector<int> m_changedIDs;	//ids written since the last TakeChangedIDs().
+	std::pmr::vector<uint8_t> m_changedMark;	//map entity ID to whether it's in m_changedIDs.
 };
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "Delta.h"
+using namespace Resecs;
+
+namespace {
+	template<typename T>
+	void put(std::vector<char>& out, T value) {
+		auto bytes = reinterpret_cast<const char*>(&value);
+		out.insert(out.end(), bytes, bytes + sizeof(T));
+	}
+
+	class DeltaReader {
+	public:
+		DeltaReader(const char* data, size_t size) : m_cursor(data), m_end(data + size) {}
+		template<typename T>
+		T Get() {
+			T value;
+			memcpy(&value, Take(sizeof(T)), sizeof(T));
+			return value;
+		}
+		const char* Take(size_t bytes) {
+			if (static_cast<size_t>(m_end - m_cursor) < bytes)
+				throw std::runtime_error("Delta is truncated!");
+			auto result = m_cursor;
+			m_cursor += bytes;
+			return result;
+		}
+		bool AtEnd() const {
+			return m_cursor == m_end;
+		}
+	private:
+		const char* m_cursor;
+		const char* m_end;
+	};
+}
+
+/* Layout: counts of entity events, component records and value bytes, then the records field by field(no padding), then the values. */
+void Resecs::Delta::Encode(std::vector<char>& out) const {
+	out.reserve(out.size() + 12 + entities.size() * 9 + components.size() * 11 + values.size());
+	put<uint32_t>(out, static_cast<uint32_t>(entities.size()));
+	put<uint32_t>(out, static_cast<uint32_t>(components.size()));
+	put<uint32_t>(out, static_cast<uint32_t>(values.size()));
+	for (auto& event : entities) {
+		put<uint32_t>(out, event.entity.index);
+		put<int32_t>(out, event.entity.generation);
+		put<uint8_t>(out, static_cast<uint8_t>(event.op));
+	}
+	for (auto& args : components) {
+		put<uint32_t>(out, args.entity.index);
+		put<int32_t>(out, args.entity.generation);
+		put<uint16_t>(out, args.componentTypeIndex);
+		put<uint8_t>(out, static_cast<uint8_t>(args.type));
+	}
+	out.insert(out.end(), values.begin(), values.end());
+}
+
+void Resecs::Delta::Decode(const char* data, size_t size) {
+	Clear();
+	DeltaReader reader(data, size);
+	auto entityCount = reader.Get<uint32_t>();
+	auto componentCount = reader.Get<uint32_t>();
+	auto valueBytes = reader.Get<uint32_t>();
+	for (uint32_t i = 0; i < entityCount; i++)
+	{
+		EntityEvent event;
+		event.entity.index = reader.Get<uint32_t>();
+		event.entity.generation = reader.Get<int32_t>();
+		event.op = static_cast<EntityOp>(reader.Get<uint8_t>());
+		if (event.op != EntityOp::Created && event.op != EntityOp::Destroyed)
+			throw std::runtime_error("Delta has an unknown entity operation!");
+		entities.push_back(event);
+	}
+	for (uint32_t i = 0; i < componentCount; i++)
+	{
+		EntityID entity;
+		entity.index = reader.Get<uint32_t>();
+		entity.generation = reader.Get<int32_t>();
+		auto typeIndex = reader.Get<uint16_t>();
+		auto type = static_cast<ComponentEventType>(reader.Get<uint8_t>());
+		if (type != ComponentEventType::Added && type != ComponentEventType::Removed)
+			throw std::runtime_error("Delta has an unknown component operation!");
+		components.push_back(ComponentEventArgs(type, entity, typeIndex));
+	}
+	auto bytes = reader.Take(valueBytes);
+	values.assign(bytes, bytes + valueBytes);
+	if (!reader.AtEnd())
+		throw std::runtime_error("Delta has trailing bytes!");
+}
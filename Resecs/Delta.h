@@ -0,0 +1,231 @@
+#pragma once
+#include <vector>
+#include <tuple>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+#include "World.h"
+#include "Entity.h"
+
+namespace Resecs {
+
+	/* Changes of a World over one frame, see DeltaRecorder.
+	Component types are given by their position in the type list of the recorder, not by their index in the World.
+	*/
+	struct Delta {
+		enum class EntityOp : uint8_t {
+			Created,
+			Destroyed,
+		};
+		struct EntityEvent {
+			EntityID entity;
+			EntityOp op;
+		};
+		/* Creations and destructions in the order they happened, so a mirror replaying them reuses the same slots. */
+		std::vector<EntityEvent> entities;
+		/* Net component changes: Added means the component is set to the next value(added or overwritten), Removed means it's gone. */
+		std::vector<ComponentEventArgs> components;
+		/* Bytes of the component of each Added in components, back to back. */
+		std::vector<char> values;
+
+		bool Empty() const {
+			return entities.empty() && components.empty();
+		}
+		void Clear() {
+			entities.clear();
+			components.clear();
+			values.clear();
+		}
+		/* Append the delta to out as bytes, e.g. to send it to another process built from the same code. */
+		void Encode(std::vector<char>& out) const;
+		/* Replace the content with a delta written by Encode(), throws if data is malformed. */
+		void Decode(const char* data, size_t size);
+	};
+
+	/* Records the changes of a World to TComps, one Delta per frame, and applies them to a mirror World.
+	The cost of Flush() and Apply() scales with the count of changes, not with the size of the World.
+	Changes recorded per frame:
+	- entity creations/destructions, in order.
+	- components of TComps added or removed.
+	- components written through GetMut()/Mut<T>(in Views and ForEachChunk), like Changed<T> filters. Writes through Get() or raw arrays(Group::Each) aren't seen.
+
+	using Replication = DeltaRecorder<Position, Velocity>;
+	Replication recorder(&world);
+	//each frame:
+	recorder.Flush(delta);
+	delta.Encode(bytes);	//send bytes, then on the other side:
+	delta.Decode(bytes.data(), bytes.size());
+	Replication::Apply(mirror, delta);
+
+	The mirror must start as a copy of the World(both empty, or loaded from the same Snapshot) and get every delta in order, so slots are reused the same way.
+	Components must be trivially copyable, and a component type can only be recorded by one recorder at a time.
+	*/
+	template<typename... TComps>
+	class DeltaRecorder {
+		static_assert(sizeof...(TComps) > 0, "DeltaRecorder needs at least one component type");
+		static_assert((true && ... && std::is_trivially_copyable<TComps>::value), "Recorded components must be trivially copyable");
+		static_assert(!(false || ... || IsSoAComponent<TComps>::value), "SoA components can't be recorded yet");
+	public:
+		explicit DeltaRecorder(World* world) :
+			m_world(world),
+			m_pools(world->getComponentManager<TComps>()...),
+			m_typeIndices({ world->ConvertComponentTypeToIndex<TComps>()... }, world->GetMemoryResource()),
+			m_createdConnection(world->OnEntitiesCreated.Connect([this](const EntityID* entities, size_t count) {
+				for (size_t i = 0; i < count; i++)
+				{
+					m_entityEvents.push_back(Delta::EntityEvent{ entities[i], Delta::EntityOp::Created });
+				}
+			})),
+			m_destroyedConnection(world->OnEntityDestroyed.Connect([this](EntityID entity) {
+				m_entityEvents.push_back(Delta::EntityEvent{ entity, Delta::EntityOp::Destroyed });
+			})) {
+			std::apply([](auto... pools) {
+				if ((false || ... || pools->IsTrackingChanges()))
+					throw std::runtime_error("This component type is already recorded by another DeltaRecorder!");
+				(pools->TrackChanges(true), ...);
+			}, m_pools);
+			for (size_t k = 0; k < sizeof...(TComps); k++)
+			{
+				m_componentConnections.push_back(world->OnComponentChangedOf(m_typeIndices[k]).Connect([this, k](const ComponentEventArgs* args, size_t count) {
+					for (size_t i = 0; i < count; i++)
+					{
+						m_touched.push_back(Touched{ static_cast<uint16_t>(k), args[i].entity.index });
+					}
+				}));
+			}
+		}
+		DeltaRecorder(const DeltaRecorder& copy) = delete;
+		~DeltaRecorder() {
+			std::apply([](auto... pools) { (pools->TrackChanges(false), ...); }, m_pools);
+		}
+
+		/* Replace delta with the changes since the last Flush(), and start recording the next frame. */
+		void Flush(Delta& delta) {
+			delta.Clear();
+			//copied, the delta doesn't live in the World's resource.
+			delta.entities.assign(m_entityEvents.begin(), m_entityEvents.end());
+			m_entityEvents.clear();
+			collectWrites(std::index_sequence_for<TComps...>());
+			//one record per component, grouped by type, so Apply() goes through one pool at a time.
+			std::sort(m_touched.begin(), m_touched.end(), [](const Touched& a, const Touched& b) {
+				return a.type != b.type ? a.type < b.type : a.index < b.index;
+			});
+			m_touched.erase(std::unique(m_touched.begin(), m_touched.end(), [](const Touched& a, const Touched& b) {
+				return a.type == b.type && a.index == b.index;
+			}), m_touched.end());
+			for (auto& touched : m_touched) {
+				writers()[touched.type](*this, touched.index, delta);
+			}
+			m_touched.clear();
+		}
+
+		/* Apply a delta recorded from a World to its mirror, throws if the mirror isn't in sync with it. */
+		static void Apply(World& mirror, const Delta& delta) {
+			for (auto& event : delta.entities) {
+				if (event.op == Delta::EntityOp::Created) {
+					if (!(mirror.Create().entityID == event.entity))
+						throw std::runtime_error("Mirror World is out of sync, it created another entity!");
+				}
+				else
+				{
+					mirror.GetEntityHandle(event.entity).Destroy();
+				}
+			}
+			const char* value = delta.values.data();
+			const char* valuesEnd = value + delta.values.size();
+			for (auto& args : delta.components) {
+				if (args.componentTypeIndex >= sizeof...(TComps))
+					throw std::runtime_error("Delta has an unknown component type!");
+				value = appliers()[args.componentTypeIndex](mirror, args, value, valuesEnd);
+			}
+		}
+	private:
+		struct Touched {
+			uint16_t type;	//position in TComps.
+			EntityIndex_t index;
+		};
+		using Writer = void(*)(DeltaRecorder&, EntityIndex_t, Delta&);
+		using Applier = const char*(*)(World&, const ComponentEventArgs&, const char*, const char*);
+
+		static const Writer* writers() {
+			static const Writer table[] = { &write<TComps>... };
+			return table;
+		}
+		static const Applier* appliers() {
+			static const Applier table[] = { &applyOne<TComps>... };
+			return table;
+		}
+
+		template<size_t... Is>
+		void collectWrites(std::index_sequence<Is...>) {
+			(collectWrites(std::get<Is>(m_pools), Is), ...);
+		}
+		template<typename T>
+		void collectWrites(ComponentManager<T>* pool, size_t type) {
+			pool->TakeChangedIDs(m_changedIDs);
+			for (auto id : m_changedIDs) {
+				m_touched.push_back(Touched{ static_cast<uint16_t>(type), static_cast<EntityIndex_t>(id) });
+			}
+		}
+
+		/* Record the current state of T of the entity at index, nothing if the entity is dead since. */
+		template<typename T>
+		static void write(DeltaRecorder& recorder, EntityIndex_t index, Delta& delta) {
+			auto world = recorder.m_world;
+			auto entity = world->m_entities[index];
+			if (entity.index != index)
+				return;
+			auto pool = world->getComponentManager<T>();
+			uint16_t type = static_cast<uint16_t>(tupleIndex<T>());
+			if (!pool->Contains(index)) {
+				delta.components.push_back(ComponentEventArgs(ComponentEventType::Removed, entity, type));
+				return;
+			}
+			delta.components.push_back(ComponentEventArgs(ComponentEventType::Added, entity, type));
+			auto bytes = reinterpret_cast<const char*>(pool->Get(index));
+			delta.values.insert(delta.values.end(), bytes, bytes + sizeof(T));
+		}
+
+		template<typename T>
+		static const char* applyOne(World& mirror, const ComponentEventArgs& args, const char* value, const char* valuesEnd) {
+			auto entity = mirror.GetEntityHandle(args.entity);
+			if (!entity.IsAlive())
+				throw std::runtime_error("Mirror World is out of sync, the entity is dead!");
+			if (args.type == ComponentEventType::Removed) {
+				//it may have been added and removed within the frame, so the mirror never saw it.
+				if (entity.Has<T>())
+					entity.Remove<T>();
+				return value;
+			}
+			if (static_cast<size_t>(valuesEnd - value) < sizeof(T))
+				throw std::runtime_error("Delta is missing component values!");
+			T component;
+			memcpy(&component, value, sizeof(T));
+			if (entity.Has<T>())
+				*entity.GetMut<T>() = component;
+			else
+				entity.Add(component);
+			return value + sizeof(T);
+		}
+
+		template<typename T>
+		static constexpr size_t tupleIndex() {
+			size_t index = 0;
+			size_t result = 0;
+			((std::is_same<T, TComps>::value ? (result = index) : 0, index++), ...);
+			return result;
+		}
+
+		World* m_world;
+		std::tuple<ComponentManager<TComps>*...> m_pools;
+		//containers allocate from the memory resource of the world.
+		std::pmr::vector<int> m_typeIndices;	//index in the World of each of TComps.
+		std::pmr::vector<Delta::EntityEvent> m_entityEvents{ m_world->GetMemoryResource() };
+		std::pmr::vector<Touched> m_touched{ m_world->GetMemoryResource() };	//components added/removed/written this frame, with duplicates.
+		std::pmr::vector<int> m_changedIDs{ m_world->GetMemoryResource() };	//reused by collectWrites.
+		std::pmr::vector<ComponentBatchEventDelegate::SignalConnection> m_componentConnections{ m_world->GetMemoryResource() };
+		EntityBatchEventDelegate::SignalConnection m_createdConnection;
+		EntityEventDelegate::SignalConnection m_destroyedConnection;
+	};
+}
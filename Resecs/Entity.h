@@ -1,11 +1,14 @@
 #pragma once
 #include "EntityID.hpp"
+#include "Utils\SoA.hpp"
 
 namespace Resecs {
 	
 	class Entity {
 	private:
 		friend class World;
+		template<typename... TComps>
+		friend class View;
 		World* world;  //reference to world.
 		Entity(World* world, EntityID entityID);
 	public:
@@ -16,26 +19,46 @@ namespace Resecs {
 		void Destroy();
 
 		/* Replace T with new one, if entity doesn't have T, do Add only.
-		This will trigger Removed(if there is a component before replace) and Added event at once.
-		To avoid that, use Get() and set fields manually.
+		An existing T is move-assigned in place and a single Updated event is fired, so groups keep the entity.
 		*/
 		template<typename T>
-		void Replace(T val) {
+		ComponentPointer<T> Replace(T val) {
 			ThrowIfSingletonTestFailed<T>();
-			if (Has<T>())
-				Remove<T>();
-			(*world->AddComponent<T>(entityID)) = val;
+			if (!Has<T>())
+				return world->AddComponent<T>(entityID, std::move(val));
+			return Patch<T>([&](T& component) {
+				component = std::move(val);
+			});
+		}
+
+		/* Edit T in place with func(T&), then fire a single Updated event(no Removed/Added, nothing copied).
+		T is marked as changed, like GetMut(). Throws if the entity doesn't have T.
+		entity.Patch<Mesh>([&](Mesh& mesh) { mesh.vertices.push_back(v); });
+		*/
+		template<typename T, typename TFunc>
+		ComponentPointer<T> Patch(TFunc func) {
+			ThrowIfSingletonTestFailed<T>();
+			return world->PatchComponent<T>(entityID, func);
 		}
 
 		/* Get pointer to T. 
 		Will return nullptr if this component doesn't exist.
 		*/
 		template<typename T>
-		T* Get() {
+		ComponentPointer<T> Get() {
 			ThrowIfSingletonTestFailed<T>();
 			return world->GetComponent<T>(entityID);
 		}
 
+		/* Same as Get(), but mark T as changed, so Changed<T> filters see it.
+		Use it when writing to T.
+		*/
+		template<typename T>
+		ComponentPointer<T> GetMut() {
+			ThrowIfSingletonTestFailed<T>();
+			return world->GetComponentMut<T>(entityID);
+		}
+
 		/* Check if the entity has T */
 		template<typename T>
 		bool Has() {
@@ -48,18 +71,25 @@ namespace Resecs {
 		Will throw exception if T already exists.
 		*/
 		template<typename T>
-		T* Add(T val) {
+		ComponentPointer<T> Add(T val) {
 			ThrowIfSingletonTestFailed<T>();
-			auto p = world->AddComponent<T>(entityID);
-			*p = val;
-			return p;
+			return world->AddComponent<T>(entityID, std::move(val));
+		}
+
+		/* Add a T constructed in place from args, e.g. Emplace<Mesh>(std::move(vertices)).
+		Nothing is default constructed or copied first. Will throw exception if T already exists.
+		*/
+		template<typename T, typename... TArgs>
+		ComponentPointer<T> Emplace(TArgs&&... args) {
+			ThrowIfSingletonTestFailed<T>();
+			return world->AddComponent<T>(entityID, std::forward<TArgs>(args)...);
 		}
 
 		/* Add a T to the entity.
 		Will throw exception if T already exists.
 		*/
 		template<typename T>
-		T* Add() {
+		ComponentPointer<T> Add() {
 			ThrowIfSingletonTestFailed<T>();
 			auto p = world->AddComponent<T>(entityID);
 			return p;
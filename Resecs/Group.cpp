@@ -1,76 +1,147 @@
 #include "Group.h"
 using namespace Resecs;
 
-Resecs::Group::GroupIterator::GroupIterator(World * world, std::unordered_set<EntityID>::const_iterator intIte) {
-	this->internalIterator = intIte;
-	this->world = world;
+Resecs::Group::GroupIterator::GroupIterator(Group * group, size_t position) {
+	this->group = group;
+	this->position = position;
 }
 
-Resecs::Group::Group(World* world, ComponentActivationBitset componentFilter) :
+Resecs::Group::Group(World* world, const QueryMask& filter, std::vector<BaseComponentManager*> ownedPools) :
 	world(world),
-	added(world->OnComponentChanged.Connect(std::bind(&Group::OnChanged, this, std::placeholders::_1))),
-	componentFilter(componentFilter){
+	filter(filter),
+	ownedPools(ownedPools),
+	worldGroupCount(world->m_groupCount) {
+	if (filter.all.none() && filter.any.none()) {
+		throw std::runtime_error("Group needs at least one required or AnyOf component!");
+	}
+	for (auto pool : ownedPools) {
+		if (pool->GetOwner() != nullptr) {
+			throw std::runtime_error("This component type is already owned by another group!");
+		}
+	}
+	for (auto pool : ownedPools) {
+		pool->SetOwner(this);
+	}
+	(*world->m_groupCount)++;
+	Connect();
 	Initialize();
 }
 
 Resecs::Group::Group(const Group & copy) :
 	world(copy.world),
-	added(copy.world->OnComponentChanged.Connect(std::bind(&Group::OnChanged, this, std::placeholders::_1))),
-	componentFilter(copy.componentFilter)
+	filter(copy.filter),
+	worldGroupCount(copy.worldGroupCount)
 {
+	(*world->m_groupCount)++;
+	Connect();
 	Initialize();
 }
 
+/* The group may outlive its world, then the world and its pools are gone and there is nothing to give back. */
+Resecs::Group::~Group() {
+	auto groupCount = worldGroupCount.lock();
+	if (groupCount == nullptr)
+		return;
+	(*groupCount)--;
+	for (auto pool : ownedPools) {
+		pool->SetOwner(nullptr);
+	}
+}
+
 Group::GroupIterator Resecs::Group::begin() {
-	return GroupIterator(world, cachedEntities.cbegin());
+	return GroupIterator(this, cachedEntities.size());
 }
 
 Group::GroupIterator Resecs::Group::end() {
-	return GroupIterator(world, cachedEntities.cend());
+	return GroupIterator(this, 0);
 }
 
 size_t Resecs::Group::Count() {
 	return cachedEntities.size();
 }
 
-/* Return a copy of current entities inside the group.
-If you use range-for on Group, you can't destroy entities or RemoveComponent component, since it will edit the collection.
-Instead clone a vector then destroy entity in it.
-*/
+bool Resecs::Group::IsOwning() {
+	return ownedPools.size() > 0;
+}
 
 std::vector<Entity> Resecs::Group::GetVectorClone() {
 	std::vector<Entity> result;
+	result.reserve(cachedEntities.size());
 	for (auto& t : cachedEntities) {
 		result.push_back(world->GetEntityHandle(t));
 	}
 	return result;
 }
 
-void Resecs::Group::OnChanged(ComponentEventArgs arg) {
-	auto find = cachedEntities.find(arg.entity);
-	if (arg.type == ComponentEventType::Added) {
-		if (find == cachedEntities.end()) {
-			if ((world->GetActivationTableFor(arg.entity) & componentFilter) == componentFilter) {
-				cachedEntities.insert(arg.entity);
-			}
+void Resecs::Group::OnChanged(const ComponentEventArgs* args, size_t count) {
+	for (size_t i = 0; i < count; i++)
+	{
+		auto& arg = args[i];
+		//an updated component doesn't change the signature.
+		if (arg.type == ComponentEventType::Updated)
+			continue;
+		bool isMember = arg.entity.index < positionOf.size() && positionOf[arg.entity.index] >= 0;
+		//with Without filters, adding a component may also make the entity leave, so always check the whole filter.
+		bool matches = filter.Match(world->GetActivationTableFor(arg.entity));
+		if (matches && !isMember) {
+			addEntity(arg.entity);
+		}
+		else if (!matches && isMember) {
+			removeEntity(arg.entity);
 		}
 	}
-	else
+}
+
+/* Listen to component types in the filter only. */
+void Resecs::Group::Connect() {
+	auto dependencies = filter.Dependencies();
+	for (size_t i = 0; i < dependencies.size(); i++)
 	{
-		if (find != cachedEntities.end()) {
-			if ((world->GetActivationTableFor(arg.entity) & componentFilter) != componentFilter) {
-				cachedEntities.erase(find);
-			}
-		}
+		if (dependencies.test(i))
+			connections.push_back(world->OnComponentChangedOf(i).Connect([this](const ComponentEventArgs* args, size_t count) {
+				OnChanged(args, count);
+			}));
 	}
 }
 
 void Resecs::Group::Initialize() {
 	cachedEntities.clear();
+	positionOf.clear();
 	world->Each(
 		[&](Entity entity) {
-		if ((world->GetActivationTableFor(entity.entityID) & componentFilter) == componentFilter) {
-			cachedEntities.insert(entity.entityID);
+		if (filter.Match(world->GetActivationTableFor(entity.entityID))) {
+			addEntity(entity.entityID);
 		}
 	});
 }
+
+void Resecs::Group::addEntity(EntityID entity) {
+	auto position = cachedEntities.size();
+	//move components of the entity right after the last member.
+	for (auto pool : ownedPools) {
+		pool->Swap(pool->IndexOf(entity.index), position);
+	}
+	cachedEntities.push_back(entity);
+	EnlargeVectorToFit(positionOf, entity.index, -1);
+	positionOf[entity.index] = position;
+	OnEntityEntered.Invoke(entity);
+}
+
+/* Called before the component is released, so owned pools still have it. */
+void Resecs::Group::removeEntity(EntityID entity) {
+	auto position = positionOf[entity.index];
+	auto last = cachedEntities.size() - 1;
+	//swap the entity with the last member, then drop it.
+	for (auto pool : ownedPools) {
+		pool->Swap(position, last);
+	}
+	cachedEntities[position] = cachedEntities[last];
+	positionOf[cachedEntities[position].index] = position;
+	cachedEntities.pop_back();
+	positionOf[entity.index] = -1;
+	OnEntityLeft.Invoke(entity);
+}
+
+bool Resecs::Group::isOwned(BaseComponentManager * pool) {
+	return pool->GetOwner() == this;
+}
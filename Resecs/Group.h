@@ -1,74 +1,141 @@
 #pragma once
+#include <vector>
+#include <tuple>
+#include <algorithm>
 #include "World.h"
 #include "Entity.h"
 
 namespace Resecs
 {
+	using GroupEventDelegate = Signal<EntityID>;
+
 	class Group {
 	public:
 		/* Iterator for group.
 		Since group only contains EntityID, the iterator returns EntityHandle, which makes Group easier to use.
+		It goes backward and reads the members again on every step, so the group may change under it, see Each().
 		*/
 		struct GroupIterator {
 		public:
-			GroupIterator(World* world, std::unordered_set<EntityID>::const_iterator intIte);
+			GroupIterator(Group* group, size_t position);
 			void operator++() {
-				internalIterator++;
+				//members after the current one may have left meanwhile.
+				position = std::min(position, group->cachedEntities.size() + 1) - 1;
 			}
 			bool operator==(const GroupIterator& ano) const {
-				return this->internalIterator == ano.internalIterator;
+				return this->position == ano.position;
 			}
 			bool operator!=(const GroupIterator& ano) const {
-				return this->internalIterator != ano.internalIterator;
+				return this->position != ano.position;
 			}
 
 			Entity operator*() {
-				return world->GetEntityHandle(*internalIterator);
+				return group->world->GetEntityHandle(group->cachedEntities[position - 1]);
 			}
 		private:
-			World* world;
-			std::unordered_set<EntityID>::const_iterator internalIterator;
+			Group* group;
+			size_t position;	//one past the current member.
 		};
 	private:
 		World* world;
-		std::unordered_set<EntityID> cachedEntities;
-		ComponentEventDelegate::SignalConnection added;
-		Group(World* world, ComponentActivationBitset componentFilter);
-		ComponentActivationBitset componentFilter;
+		//containers allocate from the memory resource of the world.
+		std::pmr::vector<EntityID> cachedEntities{ world->GetMemoryResource() };	//packed members of the group.
+		std::pmr::vector<int> positionOf{ world->GetMemoryResource() };	//map entity index to position in cachedEntities, -1 if not a member.
+		std::pmr::vector<ComponentBatchEventDelegate::SignalConnection> connections{ world->GetMemoryResource() };	//one per component type in the filter.
+		Group(World* world, const QueryMask& filter, std::vector<BaseComponentManager*> ownedPools = {});
+		QueryMask filter;
+		/* Pools kept in the same order as cachedEntities, see CreateOwningGroup(). */
+		std::vector<BaseComponentManager*> ownedPools;
+		/* Group count of the world, expired once the world is destroyed. */
+		std::weak_ptr<size_t> worldGroupCount;
 	public:
+		/* Fired when an entity starts/stops matching the group, inside AddComponent/RemoveComponent/Destroy.
+		For batched processing use a Collector instead of doing work here.
+		*/
+		GroupEventDelegate OnEntityEntered{ world->GetMemoryResource() };
+		GroupEventDelegate OnEntityLeft{ world->GetMemoryResource() };
+		/* Copy of a group is never an owning group, since pools can only be owned once. */
 		Group(const Group& copy);
-		Group::GroupIterator begin();
-		Group::GroupIterator end();
+		~Group();
+		GroupIterator begin();
+		GroupIterator end();
 		/* Return the count of entities in the group. */
 		size_t Count();
+		/* Whether the group owns pools of its components, see CreateOwningGroup(). */
+		bool IsOwning();
+		World* GetWorld() const {
+			return world;
+		}
 		/* Return a copy of current entities inside the group.
-		If you use range-for on Group, you can't destroy entities or RemoveComponent component, since it will edit the collection.
-		Instead clone a vector then destroy entity in it.
+		Range-for and Each() allow destroying the current entity, see Each(). For any other change of the group, clone a vector then change the entities in it,
+		or record the changes in a CommandBuffer and play it back after the loop.
 		*/
 		std::vector<Entity> GetVectorClone();
+
+		/* Iterate the group, and do func(Entity, TComps*...). TComps must be in the filter of the group.
+		Iteration goes backward, destroying the current entity or removing its components is allowed.
+		Entities entering the group meanwhile are not visited. Making other members leave is not safe: the last member takes their place(and their slots in owned pools),
+		so it may be visited twice and components already passed may belong to another entity. Record such changes in a CommandBuffer instead.
+		For an owning group, components it owns are read straight from the front of their pools.
+		*/
+		template<typename... TComps, typename TFunc>
+		void Each(TFunc func) {
+			auto pools = std::make_tuple(world->getComponentManager<TComps>()...);
+			bool owned[] = { isOwned(world->getComponentManager<TComps>())..., false };
+			eachInternal(func, pools, owned, std::index_sequence_for<TComps...>());
+		}
+
+		/* Field Member of a SoA component owned by this group, e.g. Column<&Position::x>().
+		The first Count() elements belong to the members in group order, the same for every owned pool, so columns of different components line up:
+		auto px = group.Column<&Position::x>();
+		auto vx = group.Column<&Velocity::x>();
+		for (size_t i = 0; i < group.Count(); i++) px[i] += vx[i] * dt;
+		*/
+		template<auto Member>
+		auto Column() {
+			auto pool = world->getComponentManager<typename MemberTraits<decltype(Member)>::Class>();
+			if (!isOwned(pool)) {
+				throw std::runtime_error("Column() needs a component owned by the group!");
+			}
+			return pool->template Column<Member>();
+		}
 	private:
-		void OnChanged(ComponentEventArgs arg);
+		void OnChanged(const ComponentEventArgs* args, size_t count);
+		void Connect();
 		void Initialize();
+		void addEntity(EntityID entity);
+		void removeEntity(EntityID entity);
+		bool isOwned(BaseComponentManager* pool);
+
+		template<typename TFunc, typename TPools, size_t... Is>
+		void eachInternal(TFunc& func, TPools& pools, const bool* owned, std::index_sequence<Is...>) {
+			for (size_t i = cachedEntities.size(); i > 0;) {
+				//func may have made several members leave, the position is clamped to the members left.
+				i = std::min(i, cachedEntities.size());
+				if (i == 0)
+					break;
+				auto entity = cachedEntities[--i];
+				func(world->GetEntityHandle(entity), (owned[Is] ? std::get<Is>(pools)->At(i) : std::get<Is>(pools)->Get(entity.index))...);
+			}
+		}
 
 		/* static methods for creating groups.*/
 	public:
-		/* Create a group. */
+		/* Create a group of entities that have all TComps.
+		With/Without/AnyOf filters are allowed too, e.g. CreateGroup<Position, Without<Disabled>>(&world).
+		*/
 		template<typename... TComps>
 		static Group CreateGroup(World* world) {
-			ComponentActivationBitset bs;
-			MarkBit<TComps...>(bs,world);
-			auto group = Group(world, bs);
+			auto group = Group(world, world->GetQueryMask<TComps...>());
 			return group;
 		}
-	private:
-		template<typename T>
-		static void MarkBit(ComponentActivationBitset& bs, World* world) {
-			bs.set(world->ConvertComponentTypeToIndex<T>());
-		}
-		template<typename T,typename U, typename... Rest>
-		static void MarkBit(ComponentActivationBitset& bs, World* world) {
-			MarkBit<T>(bs, world);
-			MarkBit<U,Rest...>(bs, world);
+		/* Create an owning group.
+		The group reorders pools of TComps so that its members sit at the front of every pool in the same order, Each() is then a linear sweep over them.
+		A component type can only be owned by one group at a time, otherwise an exception is thrown.
+		*/
+		template<typename... TComps>
+		static Group CreateOwningGroup(World* world) {
+			return Group(world, world->GetQueryMask<TComps...>(), { world->getComponentManager<TComps>()... });
 		}
 };
 }
\ No newline at end of file
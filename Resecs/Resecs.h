@@ -1,6 +1,12 @@
 #pragma once
 #include "EntityID.hpp"
 #include "Component.hpp"
+#include "Utils\Arena.hpp"
 #include "World.h"
 #include "System.hpp"
-#include "Group.h"
\ No newline at end of file
+#include "Group.h"
+#include "Collector.h"
+#include "ArchetypeWorld.h"
+#include "CommandBuffer.h"
+#include "Snapshot.h"
+#include "Delta.h"
\ No newline at end of file
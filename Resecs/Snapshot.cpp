@@ -0,0 +1,208 @@
+#include "Snapshot.h"
+#include "Utils\MappedFile.hpp"
+using namespace Resecs;
+
+namespace {
+	const char SnapshotMagic[4] = { 'R', 'S', 'N', 'P' };
+
+	/* Whether bit k of a snapshot signature is bit k of the world signature too, so signatures are copied as they are. */
+	bool isIdentity(const std::vector<int>& typeIndices, size_t registeredTypeCount) {
+		if (typeIndices.size() != registeredTypeCount)
+			return false;
+		for (size_t k = 0; k < typeIndices.size(); k++)
+		{
+			if (typeIndices[k] != static_cast<int>(k))
+				return false;
+		}
+		return true;
+	}
+}
+
+Resecs::Snapshot::Writer::Writer(const std::string& path) : m_path(path) {
+	m_file = fopen(path.c_str(), "wb");
+	if (m_file == nullptr)
+		throw std::runtime_error("Can't open " + path);
+}
+
+Resecs::Snapshot::Writer::~Writer() {
+	fclose(m_file);
+}
+
+void Resecs::Snapshot::Writer::Write(const void* data, size_t bytes) {
+	if (bytes > 0 && fwrite(data, 1, bytes, m_file) != bytes)
+		throw std::runtime_error("Can't write " + m_path);
+	m_offset += bytes;
+}
+
+void Resecs::Snapshot::Writer::Align() {
+	const char zeros[ChunkAlignment] = {};
+	Write(zeros, (ChunkAlignment - m_offset % ChunkAlignment) % ChunkAlignment);
+}
+
+Resecs::Snapshot::Reader::Reader(const std::string& path) : m_file(new MappedFile(path)) {
+	m_begin = m_file->Data();
+	m_cursor = m_begin;
+	m_end = m_begin + m_file->Size();
+}
+
+Resecs::Snapshot::Reader::~Reader() {}
+
+const char* Resecs::Snapshot::Reader::Take(size_t bytes) {
+	if (static_cast<size_t>(m_end - m_cursor) < bytes)
+		throw std::runtime_error("Snapshot file is truncated!");
+	auto result = m_cursor;
+	m_cursor += bytes;
+	return result;
+}
+
+const char* Resecs::Snapshot::Reader::TakeArray(size_t count, size_t size) {
+	if (count > static_cast<size_t>(m_end - m_cursor) / size)
+		throw std::runtime_error("Snapshot file is truncated!");
+	return Take(count * size);
+}
+
+void Resecs::Snapshot::Reader::Align() {
+	size_t offset = m_cursor - m_begin;
+	Take((ChunkAlignment - offset % ChunkAlignment) % ChunkAlignment);
+}
+
+void Resecs::Snapshot::writeEntities(World& world, Writer& writer, const std::vector<int>& typeIndices) {
+	Header header = {};
+	memcpy(header.magic, SnapshotMagic, sizeof(SnapshotMagic));
+	header.version = Version;
+	header.maxComponentCount = MAX_COMPONENT_COUNT;
+	header.typeCount = static_cast<uint32_t>(typeIndices.size());
+	header.entitySlots = world.m_entities.size();
+	header.freeListHead = world.m_freeListHead;
+	header.aliveEntityCount = world.m_aliveEntityCount;
+	header.changeTick = world.m_changeTick;
+	header.generationFloor = world.m_generationFloor;
+	writer.Write(&header, sizeof(header));
+	writer.Align();
+	writer.Write(world.m_entities.data(), world.m_entities.size() * sizeof(EntityID));
+	writer.Align();
+	//signatures are saved with bit k for the k-th saved type, so they don't depend on the type indices of the World.
+	auto& table = world.m_componentActivationTable;
+	if (isIdentity(typeIndices, world.m_componentManagers.size())) {
+		writer.Write(table.data(), table.size() * sizeof(ComponentActivationBitset));
+		return;
+	}
+	std::vector<ComponentActivationBitset> signatures(table.size());
+	for (size_t i = 0; i < table.size(); i++)
+	{
+		for (size_t k = 0; k < typeIndices.size(); k++)
+		{
+			if (table[i].test(typeIndices[k]))
+				signatures[i].set(k);
+		}
+	}
+	writer.Write(signatures.data(), signatures.size() * sizeof(ComponentActivationBitset));
+}
+
+void Resecs::Snapshot::checkEntityTable(const EntityID* entities, size_t slots, EntityIndex_t freeListHead, int aliveCount) {
+	if (slots == 0 || slots > World::NullIndex || entities[0].index != 0)
+		throw std::runtime_error("Snapshot has a corrupted entity table!");
+	size_t alive = 0;
+	for (size_t i = 0; i < slots; i++)
+	{
+		if (entities[i].index == i)
+			alive++;
+	}
+	size_t dead = slots - alive;
+	size_t linked = 0;
+	for (auto index = freeListHead; index != World::NullIndex; index = entities[index].index) {
+		//a link out of range, to an alive slot, or more links than dead slots(a cycle).
+		if (index >= slots || entities[index].index == index || ++linked > dead)
+			throw std::runtime_error("Snapshot has a corrupted free list!");
+	}
+	if (linked != dead || aliveCount < 0 || static_cast<size_t>(aliveCount) != alive)
+		throw std::runtime_error("Snapshot has a corrupted free list!");
+}
+
+void Resecs::Snapshot::readEntities(World& world, Reader& reader, const std::vector<int>& typeIndices) {
+	if (world.m_entities.size() != 1) {
+		throw std::runtime_error("Snapshot can only be loaded into an empty World!");
+	}
+	for (auto& pool : world.m_componentManagers) {
+		if (pool->Size() != 0)
+			throw std::runtime_error("Snapshot can only be loaded into an empty World!");
+	}
+	auto header = reader.Read<Header>();
+	if (memcmp(header.magic, SnapshotMagic, sizeof(SnapshotMagic)) != 0 || header.version != Version) {
+		throw std::runtime_error("Not a snapshot file, or written by another version!");
+	}
+	if (header.maxComponentCount != MAX_COMPONENT_COUNT) {
+		throw std::runtime_error("Snapshot was written with another RESECS_MAX_COMPONENT_TYPES!");
+	}
+	if (header.typeCount != typeIndices.size()) {
+		throw std::runtime_error("Snapshot has another count of component types!");
+	}
+	size_t slots = static_cast<size_t>(header.entitySlots);
+	reader.Align();
+	auto entities = reinterpret_cast<const EntityID*>(reader.TakeArray(slots, sizeof(EntityID)));
+	reader.Align();
+	auto signatures = reinterpret_cast<const ComponentActivationBitset*>(reader.TakeArray(slots, sizeof(ComponentActivationBitset)));
+	checkEntityTable(entities, slots, header.freeListHead, header.aliveEntityCount);
+
+	world.m_entities.assign(entities, entities + slots);
+	auto& table = world.m_componentActivationTable;
+	if (isIdentity(typeIndices, world.m_componentManagers.size())) {
+		table.assign(signatures, signatures + slots);
+	}
+	else
+	{
+		table.assign(slots, ComponentActivationBitset());
+		for (size_t i = 0; i < slots; i++)
+		{
+			for (size_t k = 0; k < typeIndices.size(); k++)
+			{
+				if (signatures[i].test(k))
+					table[i].set(typeIndices[k]);
+			}
+		}
+	}
+	world.m_freeListHead = header.freeListHead;
+	world.m_aliveEntityCount = header.aliveEntityCount;
+	world.m_changeTick = header.changeTick;
+	world.m_generationFloor = header.generationFloor;
+}
+
+void Resecs::Snapshot::writePoolHeader(Writer& writer, size_t componentSize, const char* name, size_t count) {
+	PoolHeader header = {};
+	header.componentSize = static_cast<uint32_t>(componentSize);
+	header.nameLength = static_cast<uint32_t>(strlen(name));
+	header.count = count;
+	writer.Write(&header, sizeof(header));
+	writer.Write(name, header.nameLength);
+}
+
+size_t Resecs::Snapshot::readPoolHeader(Reader& reader, size_t componentSize, const char* name) {
+	auto header = reader.Read<PoolHeader>();
+	auto savedName = reader.Take(header.nameLength);
+	if (header.componentSize != componentSize || header.nameLength != strlen(name) || memcmp(savedName, name, header.nameLength) != 0) {
+		throw std::runtime_error(std::string("Snapshot doesn't have component ") + name + " at this position!");
+	}
+	return static_cast<size_t>(header.count);
+}
+
+void Resecs::Snapshot::checkPoolEntities(World& world, const int* ids, size_t count, int compIndex) {
+	auto& entities = world.m_entities;
+	auto& table = world.m_componentActivationTable;
+	std::vector<bool> seen(entities.size());
+	for (size_t i = 0; i < count; i++)
+	{
+		auto id = ids[i];
+		if (id < 0 || static_cast<size_t>(id) >= entities.size() || entities[id].index != static_cast<EntityIndex_t>(id) || !table[id].test(compIndex) || seen[id])
+			throw std::runtime_error("Snapshot has a corrupted component pool!");
+		seen[id] = true;
+	}
+	//every alive entity whose signature has the component is in the pool.
+	size_t withComponent = 0;
+	for (size_t i = 0; i < entities.size(); i++)
+	{
+		if (entities[i].index == i && table[i].test(compIndex))
+			withComponent++;
+	}
+	if (withComponent != count)
+		throw std::runtime_error("Snapshot has a corrupted component pool!");
+}
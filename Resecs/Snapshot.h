@@ -0,0 +1,159 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <typeinfo>
+#include <type_traits>
+#include "World.h"
+
+namespace Resecs {
+	class MappedFile;
+
+	/* Binary snapshot of a World: the entity slot table(generations and free list), entity signatures, and the pools of TComps.
+	Snapshot::Save<Position, Velocity>(world, "level.bin");
+	World loaded;
+	Snapshot::Load<Position, Velocity>(loaded, "level.bin");
+
+	Load maps the file and copies every table and pool as a whole array, instead of creating entities and adding components one by one.
+	Loaded entities keep their EntityIDs, so handles stored in components stay valid.
+	Both sides must list the same component types in the same order, and the file is only readable by a build with the same component layouts.
+	Components must be trivially copyable, and neither SoA nor paged. Pools of types not listed are not saved.
+	Arrays in the file start at ChunkAlignment boundaries, so the mapped sections are used in place as typed arrays.
+	*/
+	class Snapshot {
+	public:
+		const static uint32_t Version = 2;
+
+		/* Write the World to path, throws if the file can't be written. */
+		template<typename... TComps>
+		static void Save(World& world, const std::string& path) {
+			checkComponents<TComps...>();
+			std::vector<int> typeIndices = { world.ConvertComponentTypeToIndex<TComps>()... };
+			Writer writer(path);
+			writeEntities(world, writer, typeIndices);
+			(writePool<TComps>(world, writer), ...);
+		}
+
+		/* Load path into world, which must have no entity but the singleton one.
+		Listeners of the loaded component types(e.g. groups created before) get Added events for every loaded component.
+		Throws if the file doesn't match TComps or is corrupted(bad entity indices, broken free list), world is then left partly loaded and should be discarded.
+		*/
+		template<typename... TComps>
+		static void Load(World& world, const std::string& path) {
+			checkComponents<TComps...>();
+			std::vector<int> typeIndices = { world.ConvertComponentTypeToIndex<TComps>()... };
+			Reader reader(path);
+			readEntities(world, reader, typeIndices);
+			std::pmr::vector<ComponentEventArgs> events(world.GetMemoryResource());
+			(readPool<TComps>(world, reader, events), ...);
+			world.notifyComponentsChanged(events);
+		}
+	private:
+		struct Header {
+			char magic[4];
+			uint32_t version;
+			uint32_t maxComponentCount;
+			uint32_t typeCount;
+			uint64_t entitySlots;
+			EntityIndex_t freeListHead;
+			int32_t aliveEntityCount;
+			uint32_t changeTick;
+			int32_t generationFloor;
+		};
+		struct PoolHeader {
+			uint32_t componentSize;
+			uint32_t nameLength;	//typeid name of the component follows the header.
+			uint64_t count;
+		};
+
+		class Writer {
+		public:
+			explicit Writer(const std::string& path);
+			Writer(const Writer& copy) = delete;
+			~Writer();
+			void Write(const void* data, size_t bytes);
+			/* Pad with zeros to the next multiple of ChunkAlignment. */
+			void Align();
+		private:
+			FILE* m_file;
+			std::string m_path;
+			size_t m_offset = 0;
+		};
+		class Reader {
+		public:
+			explicit Reader(const std::string& path);
+			Reader(const Reader& copy) = delete;
+			~Reader();
+			/* Skip bytes and return where they start, throws if the file is shorter. */
+			const char* Take(size_t bytes);
+			/* Skip count elements of size bytes, throws if the file is shorter(also when count * size overflows). */
+			const char* TakeArray(size_t count, size_t size);
+			/* Skip the padding written by Writer::Align(). */
+			void Align();
+			template<typename T>
+			T Read() {
+				T value;
+				memcpy(&value, Take(sizeof(T)), sizeof(T));
+				return value;
+			}
+		private:
+			std::unique_ptr<MappedFile> m_file;
+			const char* m_begin;
+			const char* m_cursor;
+			const char* m_end;
+		};
+
+		template<typename... TComps>
+		static void checkComponents() {
+			static_assert((true && ... && std::is_trivially_copyable<TComps>::value), "Snapshot components must be trivially copyable");
+			static_assert(!(false || ... || IsSoAComponent<TComps>::value), "SoA components can't be saved in a snapshot yet");
+			static_assert(!(false || ... || IsPagedComponent<TComps>::value), "Paged components can't be saved in a snapshot yet");
+			static_assert((true && ... && (alignof(TComps) <= ChunkAlignment)), "Snapshot components can't be aligned to more than ChunkAlignment");
+		}
+
+		static void writeEntities(World& world, Writer& writer, const std::vector<int>& typeIndices);
+		static void readEntities(World& world, Reader& reader, const std::vector<int>& typeIndices);
+		static void writePoolHeader(Writer& writer, size_t componentSize, const char* name, size_t count);
+		static size_t readPoolHeader(Reader& reader, size_t componentSize, const char* name);
+		/* Throws unless slot 0 is the alive singleton, aliveCount slots are alive, and the free list goes through every dead slot once. */
+		static void checkEntityTable(const EntityID* entities, size_t slots, EntityIndex_t freeListHead, int aliveCount);
+		/* Throws unless ids are distinct alive entities, and exactly the ones whose signature has compIndex. */
+		static void checkPoolEntities(World& world, const int* ids, size_t count, int compIndex);
+
+		template<typename T>
+		static void writePool(World& world, Writer& writer) {
+			auto pool = world.getComponentManager<T>();
+			size_t count = pool->Size();
+			writePoolHeader(writer, sizeof(T), typeid(T).name(), count);
+			writer.Align();
+			writer.Write(pool->Entities(), count * sizeof(int));
+			writer.Align();
+			writer.Write(pool->Ticks(), count * sizeof(ComponentTicks));
+			writer.Align();
+			writer.Write(pool->Data(), count * sizeof(T));
+		}
+		template<typename T>
+		static void readPool(World& world, Reader& reader, std::pmr::vector<ComponentEventArgs>& events) {
+			size_t count = readPoolHeader(reader, sizeof(T), typeid(T).name());
+			reader.Align();
+			auto ids = reinterpret_cast<const int*>(reader.TakeArray(count, sizeof(int)));
+			reader.Align();
+			auto ticks = reinterpret_cast<const ComponentTicks*>(reader.TakeArray(count, sizeof(ComponentTicks)));
+			reader.Align();
+			auto components = reinterpret_cast<const T*>(reader.TakeArray(count, sizeof(T)));
+			int compIndex = world.ConvertComponentTypeToIndex<T>();
+			checkPoolEntities(world, ids, count, compIndex);
+			auto pool = world.getComponentManager<T>();
+			pool->Assign(ids, ticks, components, count);
+			if (!world.OnComponentChanged.HasListeners() && !world.OnComponentChangedOf(compIndex).HasListeners())
+				return;
+			for (size_t i = 0; i < count; i++)
+			{
+				events.push_back(ComponentEventArgs(ComponentEventType::Added, world.m_entities[pool->Entities()[i]], compIndex));
+			}
+		}
+	};
+}
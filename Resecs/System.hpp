@@ -1,12 +1,71 @@
 #pragma once
+#include <vector>
+#include <memory>
+#include <typeindex>
+#include <atomic>
+#include <algorithm>
+#include <string>
+#include <typeinfo>
+#include "Utils\ThreadPool.hpp"
+#include "Utils\Profiler.hpp"
 
 namespace Resecs {
 	class System {
 	public:
 		virtual void Start() {}
 		virtual void Update() {}
+		virtual ~System() {}
+
+		/* Component types read / written in Update(), see Reads() and Writes(). */
+		const std::vector<std::type_index>& GetReads() const { return m_reads; }
+		const std::vector<std::type_index>& GetWrites() const { return m_writes; }
+		/* Whether Reads() or Writes() was called. */
+		bool IsAccessDeclared() const { return m_accessDeclared; }
+		/* Name of the system in profiler samples, the type name unless SetName() was called. */
+		std::string GetName() const { return m_name.empty() ? typeid(*this).name() : m_name; }
+		void SetName(std::string name) { m_name = std::move(name); }
+
+		/* Check if two systems can't run at the same time.
+		A system that doesn't declare its access is assumed to touch everything.
+		*/
+		bool ConflictsWith(const System& ano) const {
+			if (!m_accessDeclared || !ano.m_accessDeclared)
+				return true;
+			return overlaps(m_writes, ano.m_writes) || overlaps(m_writes, ano.m_reads) || overlaps(m_reads, ano.m_writes);
+		}
+	protected:
+		/* Declare component types only read in Update(). Usually called in constructor. */
+		template<typename... TComps>
+		void Reads() {
+			m_accessDeclared = true;
+			(m_reads.push_back(typeid(TComps)), ...);
+		}
+		/* Declare component types written in Update(). Usually called in constructor. */
+		template<typename... TComps>
+		void Writes() {
+			m_accessDeclared = true;
+			(m_writes.push_back(typeid(TComps)), ...);
+		}
+	private:
+		static bool overlaps(const std::vector<std::type_index>& a, const std::vector<std::type_index>& b) {
+			for (auto& type : a) {
+				if (std::find(b.begin(), b.end(), type) != b.end())
+					return true;
+			}
+			return false;
+		}
+		std::vector<std::type_index> m_reads;
+		std::vector<std::type_index> m_writes;
+		bool m_accessDeclared = false;
+		std::string m_name;
 	};
 
+	/* Run Update() of system, timed as a sample of Profiler::Default() if RESECS_PROFILING is defined. */
+	inline void UpdateSystem(System& system) {
+		RESECS_PROFILE_SCOPE(system.GetName());
+		system.Update();
+	}
+
 	class Feature : public System {
 	public:
 		std::vector<std::shared_ptr<System>> systems;
@@ -17,8 +76,76 @@ namespace Resecs {
 		}
 		virtual void Update() {
 			for (auto& pSys : systems) {
-				pSys->Update();
+				UpdateSystem(*pSys);
+			}
+		}
+	};
+
+	/* Feature that runs systems on a thread pool.
+	Two systems conflict if one writes a component type the other reads or writes(see System::ConflictsWith), conflicting systems run in the order of systems.
+	Others may run at the same time.
+	Systems that create/destroy entities or add/remove components change the World itself, don't declare their access so they run alone.
+	Component types and queries may be used for the first time by systems running at the same time, the World registers them under a lock.
+	A system that throws doesn't stop the others, the first exception is rethrown by Update() once every system ran.
+	*/
+	class ParallelFeature : public Feature {
+	public:
+		/* pool is ThreadPool::Default() if nullptr. */
+		ParallelFeature(ThreadPool* pool = nullptr) : m_pool(pool) {}
+
+		virtual void Start() {
+			Feature::Start();
+			BuildSchedule();
+		}
+		virtual void Update() {
+			if (m_schedule.size() != systems.size())
+				BuildSchedule();
+			auto& pool = m_pool == nullptr ? ThreadPool::Default() : *m_pool;
+			ThreadPool::Batch batch(m_schedule.size());
+			for (auto& node : m_schedule) {
+				node.remainingDependencies = node.dependencyCount;
 			}
+			for (size_t i = 0; i < m_schedule.size(); i++)
+			{
+				if (m_schedule[i].dependencyCount == 0)
+					submit(pool, i, batch);
+			}
+			pool.Wait(batch);
+		}
+
+		/* Rebuild the dependency graph, call it after changing systems. */
+		void BuildSchedule() {
+			m_schedule = std::vector<Node>(systems.size());
+			for (size_t i = 0; i < systems.size(); i++)
+			{
+				for (size_t j = 0; j < i; j++)
+				{
+					if (systems[i]->ConflictsWith(*systems[j])) {
+						m_schedule[j].dependents.push_back(i);
+						m_schedule[i].dependencyCount++;
+					}
+				}
+			}
+		}
+	private:
+		struct Node {
+			std::vector<size_t> dependents;	//systems that must wait for this one.
+			size_t dependencyCount = 0;
+			std::atomic<size_t> remainingDependencies{ 0 };
+			Node() = default;
+			Node(const Node& copy) : dependents(copy.dependents), dependencyCount(copy.dependencyCount) {}
+		};
+		void submit(ThreadPool& pool, size_t index, ThreadPool::Batch& batch) {
+			pool.Submit([this, &pool, index, &batch]() {
+				batch.Run([&]() { UpdateSystem(*systems[index]); });
+				for (auto dependent : m_schedule[index].dependents) {
+					if (--m_schedule[dependent].remainingDependencies == 0)
+						submit(pool, dependent, batch);
+				}
+				batch.Done();
+			});
 		}
+		ThreadPool* m_pool;
+		std::vector<Node> m_schedule;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <memory>
+#include <memory_resource>
+
+namespace Resecs {
+
+	/* Alignment of component pools and chunk buffers, a cache line, which also covers SSE/AVX/AVX-512 loads. */
+	const static size_t ChunkAlignment = 64;
+
+	/* Allocator that aligns every allocation to Alignment bytes, taken from a std::pmr::memory_resource(the default one unless given). */
+	template<typename T, size_t Alignment = ChunkAlignment>
+	class AlignedAllocator {
+	public:
+		using value_type = T;
+		template<typename U>
+		struct rebind {
+			using other = AlignedAllocator<U, Alignment>;
+		};
+
+		AlignedAllocator() noexcept : m_resource(std::pmr::get_default_resource()) {}
+		AlignedAllocator(std::pmr::memory_resource* resource) noexcept : m_resource(resource) {}
+		template<typename U>
+		AlignedAllocator(const AlignedAllocator<U, Alignment>& other) noexcept : m_resource(other.Resource()) {}
+
+		T* allocate(size_t count) {
+			return static_cast<T*>(m_resource->allocate(count * sizeof(T), alignment()));
+		}
+		void deallocate(T* p, size_t count) {
+			m_resource->deallocate(p, count * sizeof(T), alignment());
+		}
+		std::pmr::memory_resource* Resource() const {
+			return m_resource;
+		}
+		template<typename U>
+		bool operator==(const AlignedAllocator<U, Alignment>& other) const {
+			return *m_resource == *other.Resource();
+		}
+		template<typename U>
+		bool operator!=(const AlignedAllocator<U, Alignment>& other) const {
+			return !(*this == other);
+		}
+	private:
+		static constexpr size_t alignment() {
+			return Alignment > alignof(T) ? Alignment : alignof(T);
+		}
+		std::pmr::memory_resource* m_resource;
+	};
+
+	/* Deleter of objects created by NewWithResource(), remembers the size to give back. */
+	template<typename T>
+	struct ResourceDeleter {
+		std::pmr::memory_resource* resource;
+		size_t size;
+		size_t alignment;
+		void operator()(T* p) const {
+			p->~T();
+			resource->deallocate(p, size, alignment);
+		}
+	};
+	template<typename T>
+	using ResourcePtr = std::unique_ptr<T, ResourceDeleter<T>>;
+
+	/* Same as std::make_unique<TConcrete>(args...), but the object lives in resource. It can be held as a ResourcePtr to a base TPointee with a virtual destructor. */
+	template<typename TConcrete, typename TPointee = TConcrete, typename... TArgs>
+	ResourcePtr<TPointee> NewWithResource(std::pmr::memory_resource* resource, TArgs&&... args) {
+		void* memory = resource->allocate(sizeof(TConcrete), alignof(TConcrete));
+		TConcrete* object;
+		try {
+			object = new (memory) TConcrete(std::forward<TArgs>(args)...);
+		}
+		catch (...) {
+			resource->deallocate(memory, sizeof(TConcrete), alignof(TConcrete));
+			throw;
+		}
+		return ResourcePtr<TPointee>(object, ResourceDeleter<TPointee>{ resource, sizeof(TConcrete), alignof(TConcrete) });
+	}
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <memory_resource>
+#include "AlignedAllocator.hpp"
+
+namespace Resecs {
+
+	/* Memory arena for Worlds, memory is taken from upstream in big chunks.
+	Two modes:
+	- Pooled: freed blocks are reused by later allocations of the same size, for a World that keeps changing.
+	- Monotonic: deallocation does nothing, memory only comes back all at once. Destroying a World is then nearly free,
+		only destructors of components that have one still run.
+	Arena arena(64 << 20, std::pmr::get_default_resource(), Arena::Mode::Monotonic);
+	for (auto& level : levels) {
+		World world(&arena);
+		...
+		//world is destroyed here, without a single free.
+		arena.Reset();	//start over, the chunks are kept for the next level.
+	}
+	arena.Release();	//give every chunk back to upstream.
+
+	Not thread safe, like the World using it. Every object allocated from it must be gone before Reset(), Release() or the destruction of the arena.
+	*/
+	class Arena : public std::pmr::memory_resource {
+	public:
+		enum class Mode {
+			Pooled,
+			Monotonic,
+		};
+		/* initialSize is the size of the first chunk, later chunks grow geometrically. upstream gives the chunks. */
+		explicit Arena(size_t initialSize = 1 << 20, std::pmr::memory_resource* upstream = std::pmr::get_default_resource(), Mode mode = Mode::Pooled) :
+			m_chunks(initialSize, upstream),
+			m_pool(&m_chunks),
+			m_mode(mode) {}
+		Arena(const Arena& copy) = delete;
+
+		Mode GetMode() const {
+			return m_mode;
+		}
+		/* Forget every allocation but keep the chunks, so the next World reuses them without asking upstream. */
+		void Reset() {
+			m_pool.release();
+			m_chunks.Reset();
+			m_bytesAllocated = 0;
+		}
+		/* Give every chunk back to upstream, the arena can be used again afterwards. */
+		void Release() {
+			m_pool.release();
+			m_chunks.Release();
+			m_bytesAllocated = 0;
+		}
+		/* Bytes handed out and not deallocated yet. */
+		size_t BytesAllocated() const {
+			return m_bytesAllocated;
+		}
+		/* Bytes of chunks taken from upstream. */
+		size_t BytesReserved() const {
+			return m_chunks.BytesReserved();
+		}
+	protected:
+		void* do_allocate(size_t bytes, size_t alignment) override {
+			auto p = m_mode == Mode::Pooled ? m_pool.allocate(bytes, alignment) : m_chunks.allocate(bytes, alignment);
+			m_bytesAllocated += bytes;
+			return p;
+		}
+		void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+			if (m_mode == Mode::Pooled)
+				m_pool.deallocate(p, bytes, alignment);
+			m_bytesAllocated -= bytes;
+		}
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+	private:
+		/* Bump allocator over chunks from upstream. Unlike std::pmr::monotonic_buffer_resource, it can rewind and keep its chunks. */
+		class ChunkBuffer : public std::pmr::memory_resource {
+		public:
+			ChunkBuffer(size_t initialSize, std::pmr::memory_resource* upstream) :
+				m_upstream(upstream),
+				m_initialSize(initialSize < 64 ? 64 : initialSize),
+				m_nextSize(m_initialSize) {}
+			ChunkBuffer(const ChunkBuffer& copy) = delete;
+			~ChunkBuffer() {
+				Release();
+			}
+			void Reset() {
+				m_current = 0;
+				m_offset = 0;
+			}
+			void Release() {
+				for (auto& chunk : m_chunks) {
+					m_upstream->deallocate(chunk.memory, chunk.size, ChunkAlignment);
+				}
+				m_chunks.clear();
+				m_reserved = 0;
+				m_nextSize = m_initialSize;
+				Reset();
+			}
+			size_t BytesReserved() const {
+				return m_reserved;
+			}
+		protected:
+			void* do_allocate(size_t bytes, size_t alignment) override {
+				while (true) {
+					if (m_current == m_chunks.size())
+						addChunk(bytes + alignment);
+					auto& chunk = m_chunks[m_current];
+					auto base = reinterpret_cast<uintptr_t>(chunk.memory);
+					auto begin = (base + m_offset + alignment - 1) / alignment * alignment;
+					if (begin + bytes <= base + chunk.size) {
+						m_offset = begin + bytes - base;
+						return reinterpret_cast<void*>(begin);
+					}
+					//too small for this request, it's reused after the next Reset().
+					m_current++;
+					m_offset = 0;
+				}
+			}
+			void do_deallocate(void*, size_t, size_t) override {}
+			bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+				return this == &other;
+			}
+		private:
+			struct Chunk {
+				void* memory;
+				size_t size;
+			};
+			void addChunk(size_t minSize) {
+				size_t size = m_nextSize;
+				while (size < minSize) {
+					size *= 2;
+				}
+				m_chunks.push_back(Chunk{ m_upstream->allocate(size, ChunkAlignment), size });
+				m_reserved += size;
+				m_nextSize = size * 2;
+			}
+
+			std::pmr::memory_resource* m_upstream;
+			size_t m_initialSize;
+			size_t m_nextSize;
+			std::vector<Chunk> m_chunks;	//kept by Reset(), in the order they are used.
+			size_t m_current = 0;	//chunk allocations come from.
+			size_t m_offset = 0;	//in the current chunk.
+			size_t m_reserved = 0;
+		};
+
+		ChunkBuffer m_chunks;
+		std::pmr::unsynchronized_pool_resource m_pool;
+		Mode m_mode;
+		size_t m_bytesAllocated = 0;
+	};
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+namespace Resecs {
+
+	/* Fixed size bitset stored in 64-bit words.
+	Unlike std::bitset, the word array is exposed and the set operations are plain loops over words without early exit,
+	so compilers unroll and vectorize them.
+	*/
+	template<size_t N>
+	class Bitset {
+	public:
+		const static size_t WordCount = (N + 63) / 64;
+
+		bool test(size_t bit) const {
+			return (m_words[bit / 64] >> (bit % 64)) & 1;
+		}
+		void set(size_t bit) {
+			m_words[bit / 64] |= uint64_t(1) << (bit % 64);
+		}
+		void set(size_t bit, bool value) {
+			if (value)
+				set(bit);
+			else
+				reset(bit);
+		}
+		void reset(size_t bit) {
+			m_words[bit / 64] &= ~(uint64_t(1) << (bit % 64));
+		}
+		void reset() {
+			for (size_t i = 0; i < WordCount; i++)
+				m_words[i] = 0;
+		}
+		bool operator[](size_t bit) const {
+			return test(bit);
+		}
+		constexpr size_t size() const {
+			return N;
+		}
+
+		/* Check if every bit set in subset is also set in this. */
+		bool Contains(const Bitset& subset) const {
+			uint64_t missing = 0;
+			for (size_t i = 0; i < WordCount; i++)
+				missing |= subset.m_words[i] & ~m_words[i];
+			return missing == 0;
+		}
+		/* Check if any bit is set in both. */
+		bool Intersects(const Bitset& ano) const {
+			uint64_t common = 0;
+			for (size_t i = 0; i < WordCount; i++)
+				common |= m_words[i] & ano.m_words[i];
+			return common != 0;
+		}
+		bool any() const {
+			uint64_t all = 0;
+			for (size_t i = 0; i < WordCount; i++)
+				all |= m_words[i];
+			return all != 0;
+		}
+		bool none() const {
+			return !any();
+		}
+
+		Bitset operator&(const Bitset& ano) const {
+			Bitset result;
+			for (size_t i = 0; i < WordCount; i++)
+				result.m_words[i] = m_words[i] & ano.m_words[i];
+			return result;
+		}
+		Bitset operator|(const Bitset& ano) const {
+			Bitset result;
+			for (size_t i = 0; i < WordCount; i++)
+				result.m_words[i] = m_words[i] | ano.m_words[i];
+			return result;
+		}
+		bool operator==(const Bitset& ano) const {
+			uint64_t diff = 0;
+			for (size_t i = 0; i < WordCount; i++)
+				diff |= m_words[i] ^ ano.m_words[i];
+			return diff == 0;
+		}
+		bool operator!=(const Bitset& ano) const {
+			return !(*this == ano);
+		}
+
+		const uint64_t* Words() const {
+			return m_words;
+		}
+		uint64_t* Words() {
+			return m_words;
+		}
+	private:
+		uint64_t m_words[WordCount] = {};
+	};
+}
+
+/* Implement hash function for Bitset.
+So Bitset could be used as key of unordered_map
+*/
+namespace std {
+	template <size_t N>
+	struct hash<Resecs::Bitset<N>> {
+		size_t operator()(const Resecs::Bitset<N>& k) const {
+			size_t res = 17;
+			for (size_t i = 0; i < Resecs::Bitset<N>::WordCount; i++)
+				res = res * 31 + hash<uint64_t>()(k.Words()[i]);
+			return res;
+		}
+	};
+}
\ No newline at end of file
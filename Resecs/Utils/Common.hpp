@@ -8,4 +8,13 @@ namespace Resecs {
 			vecVal.resize((index + 1) * 2.0f);
 		}
 	}
+
+	/* Same as above, but new elements are filled with fillValue. */
+	template<typename T, typename TVal>
+	void EnlargeVectorToFit(T& vecVal, size_t index, TVal fillValue) {
+		if (index >= vecVal.size())
+		{
+			vecVal.resize((index + 1) * 2.0f, fillValue);
+		}
+	}
 }
\ No newline at end of file
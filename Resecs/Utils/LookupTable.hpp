@@ -0,0 +1,69 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+#include <new>
+
+namespace Resecs {
+
+	/* Map from small process-wide IDs(component type IDs, query type IDs) to values of one World.
+	Get() takes no lock and is safe while another thread calls Set(): entries live in pages that never move, found through a directory that never grows.
+	Calls to Set() must be serialized by the caller. Values are stored as std::atomic<T>, so T is an index or a pointer.
+	*/
+	template<typename T, size_t PageSize = 256, size_t PageCount = 256>
+	class LookupTable {
+		static_assert(std::is_trivially_copyable<T>::value, "LookupTable stores indices or pointers");
+	public:
+		/* Largest ID + 1 the table can hold. */
+		const static size_t Capacity = PageSize * PageCount;
+
+		LookupTable(T emptyValue, std::pmr::memory_resource* resource) : m_empty(emptyValue), m_resource(resource) {
+			for (auto& page : m_pages) {
+				page.store(nullptr, std::memory_order_relaxed);
+			}
+		}
+		LookupTable(const LookupTable& copy) = delete;
+		~LookupTable() {
+			for (auto& page : m_pages) {
+				auto entries = page.load(std::memory_order_relaxed);
+				if (entries != nullptr)
+					m_resource->deallocate(entries, sizeof(Entry) * PageSize, alignof(Entry));
+			}
+		}
+
+		/* Value of id, emptyValue if it was never set. */
+		T Get(size_t id) const {
+			if (id >= Capacity)
+				return m_empty;
+			auto entries = m_pages[id / PageSize].load(std::memory_order_acquire);
+			if (entries == nullptr)
+				return m_empty;
+			return entries[id % PageSize].load(std::memory_order_acquire);
+		}
+		/* Publish value for id, everything written before is visible to threads that Get() it. */
+		void Set(size_t id, T value) {
+			if (id >= Capacity)
+				throw std::overflow_error("Too many component/query types for a LookupTable!");
+			auto& page = m_pages[id / PageSize];
+			auto entries = page.load(std::memory_order_relaxed);
+			if (entries == nullptr) {
+				entries = static_cast<Entry*>(m_resource->allocate(sizeof(Entry) * PageSize, alignof(Entry)));
+				for (size_t i = 0; i < PageSize; i++)
+				{
+					new (entries + i) Entry(m_empty);
+				}
+				page.store(entries, std::memory_order_release);
+			}
+			entries[id % PageSize].store(value, std::memory_order_release);
+		}
+	private:
+		using Entry = std::atomic<T>;
+		static_assert(std::is_trivially_destructible<Entry>::value, "Pages are freed without destroying entries");
+		T m_empty;
+		std::pmr::memory_resource* m_resource;
+		std::array<std::atomic<Entry*>, PageCount> m_pages;
+	};
+}
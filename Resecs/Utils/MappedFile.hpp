@@ -0,0 +1,103 @@
+#pragma once
+#include <string>
+#include <cstddef>
+#include <stdexcept>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#ifndef MAP_POPULATE
+#define MAP_POPULATE 0
+#endif
+
+namespace Resecs {
+
+	/* Read-only memory mapping of a whole file, unmapped when destroyed.
+	Pages are loaded by the OS on first touch, so reading a section costs one copy from the page cache and no read() into a temporary buffer.
+	*/
+	class MappedFile {
+	public:
+		explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+			m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (m_file == INVALID_HANDLE_VALUE)
+				throw std::runtime_error("Can't open " + path);
+			LARGE_INTEGER size;
+			GetFileSizeEx(m_file, &size);
+			m_size = static_cast<size_t>(size.QuadPart);
+			if (m_size > 0) {
+				m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				if (m_mapping != nullptr)
+					m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+				if (m_data == nullptr) {
+					close();
+					throw std::runtime_error("Can't map " + path);
+				}
+			}
+#else
+			m_file = open(path.c_str(), O_RDONLY);
+			if (m_file < 0)
+				throw std::runtime_error("Can't open " + path);
+			struct stat info;
+			fstat(m_file, &info);
+			m_size = static_cast<size_t>(info.st_size);
+			if (m_size > 0) {
+				//populate the page table up front where supported, the whole file is read anyway.
+				void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, m_file, 0);
+				if (data == MAP_FAILED) {
+					close();
+					throw std::runtime_error("Can't map " + path);
+				}
+				m_data = static_cast<const char*>(data);
+				madvise(data, m_size, MADV_SEQUENTIAL);
+			}
+#endif
+		}
+		MappedFile(const MappedFile& copy) = delete;
+		~MappedFile() {
+			close();
+		}
+
+		const char* Data() const {
+			return m_data;
+		}
+		size_t Size() const {
+			return m_size;
+		}
+	private:
+		void close() {
+#ifdef _WIN32
+			if (m_data != nullptr)
+				UnmapViewOfFile(m_data);
+			if (m_mapping != nullptr)
+				CloseHandle(m_mapping);
+			if (m_file != INVALID_HANDLE_VALUE)
+				CloseHandle(m_file);
+			m_mapping = nullptr;
+			m_file = INVALID_HANDLE_VALUE;
+#else
+			if (m_data != nullptr)
+				munmap(const_cast<char*>(m_data), m_size);
+			if (m_file >= 0)
+				::close(m_file);
+			m_file = -1;
+#endif
+			m_data = nullptr;
+		}
+		const char* m_data = nullptr;
+		size_t m_size = 0;
+#ifdef _WIN32
+		HANDLE m_file = INVALID_HANDLE_VALUE;
+		HANDLE m_mapping = nullptr;
+#else
+		int m_file = -1;
+#endif
+	};
+}
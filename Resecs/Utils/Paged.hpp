@@ -0,0 +1,168 @@
+#pragma once
+#include <vector>
+#include <memory_resource>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <cstddef>
+#include <type_traits>
+#include "AlignedAllocator.hpp"
+
+namespace Resecs {
+
+	/* Page size of a paged component, declared inside the component:
+	struct Body {
+		using Paging = Resecs::Paged<256>;	//256 components per page.
+		...
+	};
+	A paged component never moves: growing the pool adds a page instead of reallocating, and removing other components doesn't touch it.
+	So a Body* stays valid until the component is removed. Iteration pays one more indirection per component.
+	*/
+	template<size_t TPageSize>
+	struct Paged {
+		static_assert(TPageSize > 0, "Pages need at least one component");
+		const static size_t PageSize = TPageSize;
+	};
+
+	template<typename T, typename = void>
+	struct IsPagedComponent : std::false_type {};
+	template<typename T>
+	struct IsPagedComponent<T, std::void_t<typename T::Paging>> : std::true_type {};
+
+	/* Storage of a paged component: components live in pages of PageSize slots, a table maps each position to its component.
+	It has the subset of std::vector interface ComponentManager uses(like SoAColumns), positions are packed but components are not.
+	Move() and Swap() exchange table entries, so components never move in memory.
+	*/
+	template<typename T, size_t PageSize>
+	class PagedStorage {
+	public:
+		explicit PagedStorage(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			m_resource(resource),
+			m_pages(resource),
+			m_objects(resource),
+			m_free(resource) {}
+		PagedStorage(const PagedStorage& copy) = delete;
+		~PagedStorage() {
+			if constexpr (!std::is_trivially_destructible<T>::value) {
+				for (auto object : m_objects) {
+					object->~T();
+				}
+			}
+			for (auto page : m_pages) {
+				m_resource->deallocate(page, pageBytes(), pageAlignment());
+			}
+		}
+
+		size_t size() const {
+			return m_objects.size();
+		}
+		size_t capacity() const {
+			return m_pages.size() * PageSize;
+		}
+		T& operator[](size_t position) {
+			return *m_objects[position];
+		}
+		const T& operator[](size_t position) const {
+			return *m_objects[position];
+		}
+
+		void reserve(size_t count) {
+			while (count > size() + m_free.size()) {
+				addPage();
+			}
+			m_objects.reserve(count);
+		}
+		template<typename... TArgs>
+		void emplace_back(TArgs&&... args) {
+			construct([&](void* slot) { new (slot) T(std::forward<TArgs>(args)...); });
+		}
+		void push_back(const T& value) {
+			construct([&](void* slot) { new (slot) T(value); });
+		}
+		void pop_back() {
+			auto object = m_objects.back();
+			object->~T();
+			m_free.push_back(object);
+			m_objects.pop_back();
+		}
+		void resize(size_t count, const T& value) {
+			reserve(count);
+			while (size() > count) {
+				pop_back();
+			}
+			while (size() < count) {
+				push_back(value);
+			}
+		}
+		/* Position to keeps the component at from, the one at to moves to from and is destroyed by the next pop_back(). */
+		void Move(size_t to, size_t from) {
+			std::swap(m_objects[to], m_objects[from]);
+		}
+		void Swap(size_t a, size_t b) {
+			std::swap(m_objects[a], m_objects[b]);
+		}
+		/* Give back pages with no live component, components never move so partly used pages stay. */
+		void shrink_to_fit() {
+			std::pmr::vector<T*> pages(m_pages.begin(), m_pages.end(), m_resource);
+			std::sort(pages.begin(), pages.end());
+			std::pmr::vector<size_t> liveCount(pages.size(), 0, m_resource);
+			for (auto object : m_objects) {
+				liveCount[pageOf(pages, object)]++;
+			}
+			auto isFreed = [&](T* object) {
+				return liveCount[pageOf(pages, object)] == 0;
+			};
+			m_free.erase(std::remove_if(m_free.begin(), m_free.end(), isFreed), m_free.end());
+			m_pages.clear();
+			for (size_t i = 0; i < pages.size(); i++)
+			{
+				if (liveCount[i] == 0)
+					m_resource->deallocate(pages[i], pageBytes(), pageAlignment());
+				else
+					m_pages.push_back(pages[i]);
+			}
+			m_pages.shrink_to_fit();
+			m_objects.shrink_to_fit();
+			m_free.shrink_to_fit();
+		}
+	private:
+		static constexpr size_t pageBytes() {
+			return PageSize * sizeof(T);
+		}
+		static constexpr size_t pageAlignment() {
+			return ChunkAlignment > alignof(T) ? ChunkAlignment : alignof(T);
+		}
+		/* Index in pages(sorted by address) of the page holding object. */
+		static size_t pageOf(const std::pmr::vector<T*>& pages, T* object) {
+			return std::upper_bound(pages.begin(), pages.end(), object, std::less<T*>()) - pages.begin() - 1;
+		}
+		void addPage() {
+			auto page = static_cast<T*>(m_resource->allocate(pageBytes(), pageAlignment()));
+			m_pages.push_back(page);
+			//pushed backward, so slots are handed out in address order.
+			for (size_t i = PageSize; i-- > 0;) {
+				m_free.push_back(page + i);
+			}
+		}
+		template<typename TConstruct>
+		void construct(TConstruct construct) {
+			if (m_free.empty())
+				addPage();
+			auto slot = m_free.back();
+			m_objects.push_back(slot);
+			try {
+				construct(slot);
+			}
+			catch (...) {
+				m_objects.pop_back();
+				throw;
+			}
+			m_free.pop_back();
+		}
+
+		std::pmr::memory_resource* m_resource;
+		std::pmr::vector<T*> m_pages;
+		std::pmr::vector<T*> m_objects;	//map position to component.
+		std::pmr::vector<T*> m_free;	//empty slots, the next one handed out is at the back.
+	};
+}
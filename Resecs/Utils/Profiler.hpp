@@ -0,0 +1,130 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+
+/* Profiling hooks(system timings, World event counters) are only compiled in with RESECS_PROFILING defined,
+set it with the Resecs_EnableProfiling CMake option. Without it they compile to nothing, but Profiler itself stays usable.
+*/
+#ifdef RESECS_PROFILING
+#define RESECS_PROFILE_CONCAT_IMPL(a, b) a##b
+#define RESECS_PROFILE_CONCAT(a, b) RESECS_PROFILE_CONCAT_IMPL(a, b)
+/* Time the rest of the enclosing scope as a sample named name(a std::string or const char*). */
+#define RESECS_PROFILE_SCOPE(name) ::Resecs::ProfileScope RESECS_PROFILE_CONCAT(resecsProfileScope, __LINE__)(name)
+#else
+#define RESECS_PROFILE_SCOPE(name) ((void)0)
+#endif
+
+namespace Resecs {
+
+	/* A timed scope, e.g. one Update() of a system. Times are nanoseconds since the Profiler was created. */
+	struct ProfileSample {
+		std::string name;
+		uint64_t start;
+		uint64_t duration;
+		size_t thread;	//hash of the id of the thread it ran on.
+	};
+
+	/* Keeps the latest Capacity() samples in a ring buffer, older ones are overwritten.
+	Safe to record from several threads, e.g. systems of a ParallelFeature.
+	*/
+	class Profiler {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		explicit Profiler(size_t capacity = 4096) : m_capacity(std::max<size_t>(1, capacity)), m_origin(Clock::now()) {
+			m_samples.reserve(m_capacity);
+		}
+		Profiler(const Profiler& copy) = delete;
+
+		/* Profiler the built-in hooks record to. */
+		static Profiler& Default() {
+			static Profiler profiler;
+			return profiler;
+		}
+
+		size_t Capacity() const {
+			return m_capacity;
+		}
+		/* Nanoseconds since the profiler was created. */
+		uint64_t Now() const {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_origin).count();
+		}
+		void Record(std::string name, uint64_t start, uint64_t duration) {
+			ProfileSample sample{ std::move(name), start, duration, std::hash<std::thread::id>()(std::this_thread::get_id()) };
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_samples.size() < m_capacity)
+				m_samples.push_back(std::move(sample));
+			else
+				m_samples[m_next] = std::move(sample);
+			m_next = (m_next + 1) % m_capacity;
+		}
+		/* Copy of the kept samples, oldest first. */
+		std::vector<ProfileSample> Samples() const {
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_samples.size() < m_capacity)
+				return m_samples;
+			std::vector<ProfileSample> result(m_samples.begin() + m_next, m_samples.end());
+			result.insert(result.end(), m_samples.begin(), m_samples.begin() + m_next);
+			return result;
+		}
+		void Clear() {
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_samples.clear();
+			m_next = 0;
+		}
+
+		/* Write the kept samples in the Chrome trace event format, open it in chrome://tracing or ui.perfetto.dev. */
+		bool WriteChromeTrace(const std::string& path) const {
+			FILE* file = fopen(path.c_str(), "w");
+			if (file == nullptr)
+				return false;
+			auto samples = Samples();
+			fprintf(file, "{\"traceEvents\":[");
+			for (size_t i = 0; i < samples.size(); i++)
+			{
+				auto& sample = samples[i];
+				fprintf(file, "%s\n{\"name\":\"%s\",\"cat\":\"resecs\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%zu}",
+					i == 0 ? "" : ",", escape(sample.name).c_str(), sample.start / 1000.0, sample.duration / 1000.0, sample.thread % 1000000);
+			}
+			fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+			return fclose(file) == 0;
+		}
+	private:
+		static std::string escape(const std::string& text) {
+			std::string result;
+			for (char c : text) {
+				if (c == '"' || c == '\\')
+					result.push_back('\\');
+				if (static_cast<unsigned char>(c) >= 0x20)
+					result.push_back(c);
+			}
+			return result;
+		}
+		size_t m_capacity;
+		Clock::time_point m_origin;
+		mutable std::mutex m_mutex;
+		std::vector<ProfileSample> m_samples;
+		size_t m_next = 0;	//slot the next sample goes to.
+	};
+
+	/* Records the lifetime of the scope to Profiler::Default(), see RESECS_PROFILE_SCOPE. */
+	class ProfileScope {
+	public:
+		explicit ProfileScope(std::string name) : m_name(std::move(name)), m_start(Profiler::Default().Now()) {}
+		ProfileScope(const ProfileScope& copy) = delete;
+		~ProfileScope() {
+			auto& profiler = Profiler::Default();
+			profiler.Record(std::move(m_name), m_start, profiler.Now() - m_start);
+		}
+	private:
+		std::string m_name;
+		uint64_t m_start;
+	};
+}
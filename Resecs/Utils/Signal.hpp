@@ -2,15 +2,18 @@
 #include <utility>
 #include <list>
 #include <memory>
+#include <memory_resource>
 
 namespace Resecs {
 
-	/* Signal class for implementing event. */
+	/* Signal class for implementing event.
+	Connections are kept in nodes taken from resource, callbacks too big for the small buffer of std::function still go to the global heap.
+	*/
 	template <typename... TFuncArgs>
 	class Signal {
 	public:
 		using Callback = std::function<void(TFuncArgs...)>;
-		Signal() : survivePtr(std::make_shared<int>(0)) {
+		explicit Signal(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : callbacks(resource), survivePtr(std::make_shared<int>(0)) {
 		}
 		/* Connection class.
 		Disconnect() will be called automatically once it's out of scope.
@@ -28,7 +31,10 @@ namespace Resecs {
 			/* A copy constructor of "connection" is really confusing. just delete it. */
 			SignalConnection(const SignalConnection& copy) = delete;
 			/* without a copy constructor, we can't return SignalConnection, unless we provide a move constructor. */
-			SignalConnection(SignalConnection&& toMove) noexcept : id(toMove.id), signal(toMove.signal), disconnected(toMove.disconnected), signalSurvivePtr(toMove.signalSurvivePtr) {}
+			SignalConnection(SignalConnection&& toMove) noexcept : id(toMove.id), signal(toMove.signal), disconnected(toMove.disconnected), signalSurvivePtr(toMove.signalSurvivePtr) {
+				//the moved-from connection must not disconnect the callback when destroyed.
+				toMove.disconnected = true;
+			}
 			~SignalConnection() {
 				Disconnect();
 			}
@@ -58,13 +64,18 @@ namespace Resecs {
 			Invoke(args...);
 		}
 
+		/* Whether anyone is connected, lets callers skip building arguments nobody listens to. */
+		bool HasListeners() const {
+			return !callbacks.empty();
+		}
+
 	private:
 		/* ID Counter.
 		We look for the connection's corresponding callback using index, since the operator== of std::function doesn't work as imagine.
 		*/
 		int idRoller = 0;
-		std::list<std::pair<int, Callback>> callbacks;
-		std::shared_ptr<int> survivePtr;
+		std::pmr::list<std::pair<int, Callback>> callbacks;
+		std::shared_ptr<int> survivePtr;	//on the global heap, since connections may outlive the resource.
 
 		/* Only SignalConnection can call this method.
 		*/
@@ -0,0 +1,220 @@
+#pragma once
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <cstddef>
+#include <type_traits>
+#include "AlignedAllocator.hpp"
+#include "Paged.hpp"
+
+namespace Resecs {
+
+	/* Field list of a struct-of-arrays component, declared inside the component:
+	struct Position {
+		float x, y, z;
+		using SoALayout = Resecs::SoAFields<&Position::x, &Position::y, &Position::z>;
+	};
+	Every field of the component must be listed, fields not listed are lost when the component is stored.
+	*/
+	template<auto... Members>
+	struct SoAFields {};
+
+	template<typename T>
+	struct MemberTraits;
+	template<typename TClass, typename TField>
+	struct MemberTraits<TField TClass::*> {
+		using Class = TClass;
+		using Field = TField;
+	};
+
+	template<typename T, typename = void>
+	struct IsSoAComponent : std::false_type {};
+	template<typename T>
+	struct IsSoAComponent<T, std::void_t<typename T::SoALayout>> : std::true_type {};
+
+	template<typename T, typename TLayout = typename T::SoALayout>
+	class SoAColumns;
+
+	/* Pointer-like handle to a component in SoAColumns.
+	Dereferencing gives a Reference, which holds a copy of the component and writes it back to the columns when it goes out of scope.
+	So p->x += 1 works like a plain pointer, but hot loops should use the columns directly(see Group::Column()).
+	*/
+	template<typename T>
+	class SoAPointer {
+	public:
+		class Reference {
+		public:
+			Reference(SoAColumns<T>* columns, size_t position) :
+				m_columns(columns), m_position(position), m_value(columns->Load(position)) {}
+			Reference(const Reference& copy) = delete;
+			~Reference() {
+				m_columns->Store(m_position, m_value);
+			}
+			Reference& operator=(const T& value) {
+				m_value = value;
+				return *this;
+			}
+			operator T() const {
+				return m_value;
+			}
+			T* operator->() {
+				return &m_value;
+			}
+		private:
+			SoAColumns<T>* m_columns;
+			size_t m_position;
+			T m_value;
+		};
+
+		SoAPointer(std::nullptr_t = nullptr) : m_columns(nullptr), m_position(0) {}
+		SoAPointer(SoAColumns<T>* columns, size_t position) : m_columns(columns), m_position(position) {}
+
+		Reference operator*() const {
+			return Reference(m_columns, m_position);
+		}
+		Reference operator->() const {
+			return Reference(m_columns, m_position);
+		}
+		explicit operator bool() const {
+			return m_columns != nullptr;
+		}
+		bool operator==(const SoAPointer& ano) const {
+			return m_columns == ano.m_columns && m_position == ano.m_position;
+		}
+		bool operator!=(const SoAPointer& ano) const {
+			return !(*this == ano);
+		}
+	private:
+		SoAColumns<T>* m_columns;
+		size_t m_position;
+	};
+
+	/* Storage of a SoA component, one std::vector per field.
+	It has the subset of std::vector interface ComponentManager uses, so the pool logic is shared with array-of-structs components.
+	*/
+	template<typename T, auto... Members>
+	class SoAColumns<T, SoAFields<Members...>> {
+		static_assert(sizeof...(Members) > 0, "SoALayout needs at least one field");
+		static_assert(std::is_default_constructible<T>::value, "SoA component must be default constructible");
+		template<auto Member>
+		using ColumnOf = std::vector<typename MemberTraits<decltype(Member)>::Field, AlignedAllocator<typename MemberTraits<decltype(Member)>::Field>>;
+	public:
+		using Pointer = SoAPointer<T>;
+
+		/* Every column allocates from resource. */
+		explicit SoAColumns(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			m_columns(ColumnOf<Members>(resource)...) {}
+
+		size_t size() const {
+			return std::get<0>(m_columns).size();
+		}
+		size_t capacity() const {
+			return std::get<0>(m_columns).capacity();
+		}
+		void shrink_to_fit() {
+			std::apply([&](auto&... columns) { (columns.shrink_to_fit(), ...); }, m_columns);
+		}
+		void reserve(size_t count) {
+			std::apply([&](auto&... columns) { (columns.reserve(count), ...); }, m_columns);
+		}
+		template<typename... TArgs>
+		void emplace_back(TArgs&&... args) {
+			push_back(T(std::forward<TArgs>(args)...));
+		}
+		void push_back(const T& value) {
+			pushBack(value, std::index_sequence_for<decltype(Members)...>());
+		}
+		void pop_back() {
+			std::apply([&](auto&... columns) { (columns.pop_back(), ...); }, m_columns);
+		}
+		void resize(size_t count, const T& value) {
+			resize(count, value, std::index_sequence_for<decltype(Members)...>());
+		}
+
+		/* Gather the component at position. */
+		T Load(size_t position) const {
+			T value;
+			load(value, position, std::index_sequence_for<decltype(Members)...>());
+			return value;
+		}
+		/* Scatter value to position. */
+		void Store(size_t position, const T& value) {
+			store(value, position, std::index_sequence_for<decltype(Members)...>());
+		}
+		void Move(size_t to, size_t from) {
+			std::apply([&](auto&... columns) { ((columns[to] = std::move(columns[from])), ...); }, m_columns);
+		}
+		void Swap(size_t a, size_t b) {
+			std::apply([&](auto&... columns) { (std::swap(columns[a], columns[b]), ...); }, m_columns);
+		}
+
+		/* Contiguous array of field Member, size() of them. */
+		template<auto Member>
+		auto Column() {
+			constexpr size_t index = indexOf<Member>();
+			static_assert(index < sizeof...(Members), "Member is not in the SoALayout of the component");
+			return std::get<index>(m_columns).data();
+		}
+	private:
+		template<auto A, auto B>
+		static constexpr bool sameMember() {
+			if constexpr (std::is_same<decltype(A), decltype(B)>::value)
+				return A == B;
+			else
+				return false;
+		}
+		template<auto Member>
+		static constexpr size_t indexOf() {
+			size_t index = 0;
+			size_t result = sizeof...(Members);
+			((sameMember<Member, Members>() ? (result = index) : 0, index++), ...);
+			return result;
+		}
+
+		template<size_t... Is>
+		void pushBack(const T& value, std::index_sequence<Is...>) {
+			(std::get<Is>(m_columns).push_back(value.*Members), ...);
+		}
+		template<size_t... Is>
+		void resize(size_t count, const T& value, std::index_sequence<Is...>) {
+			(std::get<Is>(m_columns).resize(count, value.*Members), ...);
+		}
+		template<size_t... Is>
+		void load(T& value, size_t position, std::index_sequence<Is...>) const {
+			((value.*Members = std::get<Is>(m_columns)[position]), ...);
+		}
+		template<size_t... Is>
+		void store(const T& value, size_t position, std::index_sequence<Is...>) {
+			((std::get<Is>(m_columns)[position] = value.*Members), ...);
+		}
+
+		std::tuple<ColumnOf<Members>...> m_columns;
+	};
+
+	/* Storage used by ComponentManager<T>, SoAColumns if T declares a SoALayout, PagedStorage if it declares Paging, std::vector otherwise.
+	All are aligned to ChunkAlignment, and constructible from the std::pmr::memory_resource they allocate from.
+	*/
+	template<typename T, bool = IsSoAComponent<T>::value, bool = IsPagedComponent<T>::value>
+	struct ComponentStorage {
+		using Type = std::vector<T, AlignedAllocator<T>>;
+		using Pointer = T*;
+	};
+	template<typename T>
+	struct ComponentStorage<T, true, false> {
+		using Type = SoAColumns<T>;
+		using Pointer = SoAPointer<T>;
+	};
+	template<typename T>
+	struct ComponentStorage<T, false, true> {
+		using Type = PagedStorage<T, T::Paging::PageSize>;
+		using Pointer = T*;
+	};
+	template<typename T>
+	struct ComponentStorage<T, true, true> {
+		static_assert(!IsSoAComponent<T>::value, "A component can't be both SoA and paged");
+	};
+
+	/* What World/Entity/View return for component T, T* unless T is a SoA component. */
+	template<typename T>
+	using ComponentPointer = typename ComponentStorage<T>::Pointer;
+}
@@ -0,0 +1,209 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <algorithm>
+#include <exception>
+
+namespace Resecs {
+
+	/* Work-stealing thread pool.
+	Every worker owns a task queue. A worker pops tasks from the back of its own queue, and steals from the front of other queues when it runs out of work.
+	Threads waiting on tasks (e.g. in ParallelFor) run pending tasks instead of blocking, so it's fine to use the pool from inside a task.
+	*/
+	class ThreadPool {
+	public:
+		using Task = std::function<void()>;
+
+		/* Tasks waited on together, see Wait().
+		Every task calls Done() once when finished, wrapping the work in Run() so an exception it throws is kept for Wait() instead of killing the worker.
+		*/
+		class Batch {
+		public:
+			explicit Batch(size_t taskCount) : m_pending(taskCount) {}
+			Batch(const Batch& copy) = delete;
+
+			/* Call func, keeping the first exception thrown by a task of the batch. */
+			template<typename TFunc>
+			void Run(TFunc&& func) noexcept {
+				try {
+					func();
+				}
+				catch (...) {
+					std::lock_guard<std::mutex> lock(m_errorMutex);
+					if (!m_error)
+						m_error = std::current_exception();
+				}
+			}
+			void Done() {
+				m_pending--;
+			}
+		private:
+			friend class ThreadPool;
+			std::atomic<size_t> m_pending;
+			std::exception_ptr m_error;
+			std::mutex m_errorMutex;
+		};
+
+		/* threadCount is the total count of threads doing work, including the thread waiting on the pool.
+		So ThreadPool(1) creates no worker, and all work is done on the calling thread.
+		*/
+		explicit ThreadPool(size_t threadCount = std::max(1u, std::thread::hardware_concurrency())) :
+			m_queues(std::max<size_t>(1, threadCount)) {
+			for (auto& queue : m_queues) {
+				queue = std::make_unique<WorkerQueue>();
+			}
+			for (size_t i = 1; i < m_queues.size(); i++)
+			{
+				m_threads.emplace_back([this, i]() { workerLoop(i); });
+			}
+		}
+		ThreadPool(const ThreadPool& copy) = delete;
+		~ThreadPool() {
+			{
+				std::lock_guard<std::mutex> lock(m_sleepMutex);
+				m_stop = true;
+			}
+			m_wakeUp.notify_all();
+			for (auto& thread : m_threads) {
+				thread.join();
+			}
+		}
+
+		/* Total count of threads doing work, see constructor. */
+		size_t ThreadCount() const {
+			return m_queues.size();
+		}
+
+		/* Queue a task. Tasks submitted from a worker go to its own queue.
+		An exception escaping task is dropped, run the work through Batch::Run() to get it back from Wait().
+		*/
+		void Submit(Task task) {
+			size_t queueIndex = t_owner == this ? t_workerIndex : m_nextQueue++ % m_queues.size();
+			{
+				std::lock_guard<std::mutex> lock(m_sleepMutex);
+				m_queuedTasks++;
+			}
+			{
+				std::lock_guard<std::mutex> lock(m_queues[queueIndex]->mutex);
+				m_queues[queueIndex]->tasks.push_back(std::move(task));
+			}
+			m_wakeUp.notify_one();
+		}
+
+		/* Run pending tasks on the calling thread until every task of batch is done, then rethrow the first exception one of them threw. */
+		void Wait(Batch& batch) {
+			while (batch.m_pending > 0) {
+				if (!tryRunOne(t_owner == this ? t_workerIndex : 0))
+					std::this_thread::yield();
+			}
+			if (batch.m_error)
+				std::rethrow_exception(batch.m_error);
+		}
+
+		/* Call func(begin, end) for every grainSize-long range in [0, count), and wait for all of them.
+		The calling thread takes part in the work. If func throws, the other ranges still run and the first exception is rethrown here.
+		*/
+		template<typename TFunc>
+		void ParallelFor(size_t count, size_t grainSize, TFunc func) {
+			grainSize = std::max<size_t>(1, grainSize);
+			if (count <= grainSize || m_queues.size() == 1) {
+				if (count > 0)
+					func(size_t(0), count);
+				return;
+			}
+			Batch batch((count + grainSize - 1) / grainSize);
+			for (size_t begin = 0; begin < count; begin += grainSize) {
+				auto end = std::min(count, begin + grainSize);
+				Submit([&func, &batch, begin, end]() {
+					batch.Run([&]() { func(begin, end); });
+					batch.Done();
+				});
+			}
+			Wait(batch);
+		}
+
+		/* Pool shared by everything that doesn't get one explicitly, uses all hardware threads. */
+		static ThreadPool& Default() {
+			static ThreadPool pool;
+			return pool;
+		}
+	private:
+		struct WorkerQueue {
+			std::mutex mutex;
+			std::deque<Task> tasks;
+		};
+
+		void workerLoop(size_t workerIndex) {
+			t_owner = this;
+			t_workerIndex = workerIndex;
+			while (true) {
+				if (tryRunOne(workerIndex))
+					continue;
+				std::unique_lock<std::mutex> lock(m_sleepMutex);
+				m_wakeUp.wait(lock, [this]() { return m_stop || m_queuedTasks > 0; });
+				if (m_stop)
+					return;
+			}
+		}
+
+		/* Pop a task from own queue, or steal one from others. Returns false if there's nothing to do. */
+		bool tryRunOne(size_t workerIndex) {
+			Task task;
+			if (!tryPop(workerIndex, task)) {
+				for (size_t i = 1; i < m_queues.size(); i++)
+				{
+					if (trySteal((workerIndex + i) % m_queues.size(), task))
+						break;
+				}
+			}
+			if (!task)
+				return false;
+			{
+				std::lock_guard<std::mutex> lock(m_sleepMutex);
+				m_queuedTasks--;
+			}
+			//an exception must not leave a worker, or a Wait() with other tasks of its batch still running.
+			try {
+				task();
+			}
+			catch (...) {}
+			return true;
+		}
+		bool tryPop(size_t queueIndex, Task& task) {
+			auto& queue = *m_queues[queueIndex];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (queue.tasks.empty())
+				return false;
+			task = std::move(queue.tasks.back());
+			queue.tasks.pop_back();
+			return true;
+		}
+		bool trySteal(size_t queueIndex, Task& task) {
+			auto& queue = *m_queues[queueIndex];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (queue.tasks.empty())
+				return false;
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+			return true;
+		}
+
+		std::vector<std::unique_ptr<WorkerQueue>> m_queues;	//queue 0 belongs to threads outside the pool.
+		std::vector<std::thread> m_threads;
+		std::mutex m_sleepMutex;
+		std::condition_variable m_wakeUp;
+		size_t m_queuedTasks = 0;	//guarded by m_sleepMutex.
+		bool m_stop = false;	//guarded by m_sleepMutex.
+		std::atomic<size_t> m_nextQueue{ 0 };
+
+		/* Pool and queue index of the current thread, if it's a worker. */
+		inline static thread_local ThreadPool* t_owner = nullptr;
+		inline static thread_local size_t t_workerIndex = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,342 @@
+#pragma once
+#include <tuple>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#include "World.h"
+#include "Utils\ThreadPool.hpp"
+
+namespace Resecs {
+
+	/* Filters for View, each of them still passes T*(or SoAPointer<T>) to the callback.
+	Changed<T>: T was added or written through GetMut()/Mut<T> after the since tick of the view.
+	Added<T>: T was added after the since tick of the view.
+	Mut<T>: no filter, but mark T as changed for every entity visited.
+	*/
+	template<typename T>
+	struct Changed {};
+	template<typename T>
+	struct Added {};
+	template<typename T>
+	struct Mut {};
+
+	/* Filters on the set of components, they don't pass anything to the callback. Also usable in Group::CreateGroup.
+	With<Ts...>: has all of Ts.
+	Without<Ts...>: has none of Ts.
+	AnyOf<Ts...>: has at least one of Ts, only one AnyOf is allowed per query.
+	*/
+	template<typename... Ts>
+	struct With {};
+	template<typename... Ts>
+	struct Without {};
+	template<typename... Ts>
+	struct AnyOf {};
+
+	/* How a View term is matched and fetched. */
+	template<typename T>
+	struct QueryTerm {
+		using Component = T;
+		const static bool IsFilter = false;
+		static void AddToMask(World& world, QueryMask& mask) {
+			mask.all.set(world.ConvertComponentTypeToIndex<T>());
+		}
+		static bool Match(ComponentManager<T>* /*pool*/, int /*index*/, uint32_t /*since*/) {
+			return true;
+		}
+		static ComponentPointer<T> Fetch(ComponentManager<T>* pool, int index, uint32_t /*tick*/) {
+			return pool->Get(index);
+		}
+		/* Fetch from one of several threads running on distinct entities. */
+		static ComponentPointer<T> FetchConcurrent(ComponentManager<T>* pool, int index, uint32_t /*tick*/) {
+			return pool->Get(index);
+		}
+		const static bool IsMut = false;
+	};
+	template<typename T>
+	struct QueryTerm<Changed<T>> : QueryTerm<T> {
+		static bool Match(ComponentManager<T>* pool, int index, uint32_t since) {
+			return pool->GetTicks(index).ChangedSince(since);
+		}
+	};
+	template<typename T>
+	struct QueryTerm<Added<T>> : QueryTerm<T> {
+		static bool Match(ComponentManager<T>* pool, int index, uint32_t since) {
+			return pool->GetTicks(index).AddedSince(since);
+		}
+	};
+	template<typename T>
+	struct QueryTerm<Mut<T>> : QueryTerm<T> {
+		static ComponentPointer<T> Fetch(ComponentManager<T>* pool, int index, uint32_t tick) {
+			return pool->GetMut(index, tick);
+		}
+		static ComponentPointer<T> FetchConcurrent(ComponentManager<T>* pool, int index, uint32_t tick) {
+			return pool->GetMutConcurrent(index, tick);
+		}
+		const static bool IsMut = true;
+	};
+	template<typename... Ts>
+	struct QueryTerm<With<Ts...>> {
+		const static bool IsFilter = true;
+		static void AddToMask(World& world, QueryMask& mask) {
+			(mask.all.set(world.ConvertComponentTypeToIndex<Ts>()), ...);
+		}
+	};
+	template<typename... Ts>
+	struct QueryTerm<Without<Ts...>> {
+		const static bool IsFilter = true;
+		static void AddToMask(World& world, QueryMask& mask) {
+			(mask.none.set(world.ConvertComponentTypeToIndex<Ts>()), ...);
+		}
+	};
+	template<typename... Ts>
+	struct QueryTerm<AnyOf<Ts...>> {
+		const static bool IsFilter = true;
+		static void AddToMask(World& world, QueryMask& mask) {
+			(mask.any.set(world.ConvertComponentTypeToIndex<Ts>()), ...);
+		}
+	};
+
+	template<typename T>
+	struct IsAnyOfTerm : std::false_type {};
+	template<typename... Ts>
+	struct IsAnyOfTerm<AnyOf<Ts...>> : std::true_type {};
+
+	/* std::tuple of the terms that pass a component to the callback. */
+	template<typename... TTerms>
+	using FetchedTerms = decltype(std::tuple_cat(std::declval<std::conditional_t<QueryTerm<TTerms>::IsFilter, std::tuple<>, std::tuple<TTerms>>>()...));
+
+	template<typename TFetched>
+	struct FetchedTypes;
+	template<typename... TFetched>
+	struct FetchedTypes<std::tuple<TFetched...>> {
+		using Value = std::tuple<Entity, ComponentPointer<typename QueryTerm<TFetched>::Component>...>;
+		using Pools = std::tuple<ComponentManager<typename QueryTerm<TFetched>::Component>*...>;
+	};
+
+	/* Query over all entities that have every TComps.
+	The filter is compiled into a QueryMask once per World, and the component pools are resolved once when the view is created.
+	Iteration is driven by the smallest pool among fetched and With components.
+	Per entity there is no hash lookup and no indirect call, so prefer View over Get() in hot loops.
+	Iteration goes backward, destroying the current entity or removing its components is allowed.
+	Creating entities and adding components is allowed too, new members of the driving pool are not visited.
+	Adding a T may move the pool of T, so the passed T* must not be used after that.
+	Removing components of other entities may skip or repeat entities.
+
+	for (auto [entity, pPos, pVel] : world.View<Position, Velocity>()) {...}
+	world.View<Position, Velocity>().Each([](Entity entity, Position* pPos, Velocity* pVel) {...});
+	world.View<Changed<Position>>(since).Each([](Entity entity, Position* pPos) {...});
+	world.View<Position, Without<Disabled>, AnyOf<Player, Enemy>>().Each([](Entity entity, Position* pPos) {...});
+	*/
+	template<typename... TComps>
+	class View {
+		using Fetched = FetchedTerms<TComps...>;
+		const static size_t FetchedCount = std::tuple_size<Fetched>::value;
+		using FetchedIndices = std::make_index_sequence<FetchedCount>;
+		template<size_t I>
+		using Term = QueryTerm<std::tuple_element_t<I, Fetched>>;
+		const static bool HasFilterTerms = (false || ... || QueryTerm<TComps>::IsFilter);
+		template<size_t... Is>
+		static constexpr bool hasMutTerms(std::index_sequence<Is...>) {
+			return (false || ... || Term<Is>::IsMut);
+		}
+		const static bool HasMutTerms = hasMutTerms(FetchedIndices());
+
+		static_assert(sizeof...(TComps) > 0, "View needs at least one component type");
+		static_assert((0 + ... + IsAnyOfTerm<TComps>::value) <= 1, "Only one AnyOf is allowed in a query");
+	public:
+		using Value = typename FetchedTypes<Fetched>::Value;
+
+		class Iterator {
+		public:
+			Iterator(const View* view, size_t position) :
+				m_view(view),
+				m_entities(view->m_driver->Entities()),
+				m_version(view->m_driver->GetVersion()),
+				m_position(position) {
+				skipUnmatched();
+			}
+			Iterator& operator++() {
+				refresh();
+				if (m_position > 0)
+					m_position--;
+				skipUnmatched();
+				return *this;
+			}
+			bool operator==(const Iterator& ano) const {
+				return m_position == ano.m_position;
+			}
+			bool operator!=(const Iterator& ano) const {
+				return m_position != ano.m_position;
+			}
+			Value operator*() const {
+				return m_view->get(m_entities[m_position - 1], FetchedIndices());
+			}
+		private:
+			/* The loop body may have grown(and moved) or shrunk the driving pool. */
+			void refresh() {
+				auto driver = m_view->m_driver;
+				if (driver->GetVersion() == m_version)
+					return;
+				m_entities = driver->Entities();
+				m_version = driver->GetVersion();
+				m_position = std::min(m_position, driver->Size() + 1);
+			}
+			void skipUnmatched() {
+				while (m_position > 0 && !m_view->contains(m_entities[m_position - 1], FetchedIndices()))
+					m_position--;
+			}
+			const View* m_view;
+			const int* m_entities;
+			uint32_t m_version;	//of the driving pool when m_entities was read.
+			size_t m_position;	//one past the current position in the driving pool.
+		};
+
+		Iterator begin() const {
+			return Iterator(this, m_driver->Size());
+		}
+		Iterator end() const {
+			return Iterator(this, 0);
+		}
+
+		/* Call func(Entity, TComps*...) for every matching entity, filter terms pass nothing. */
+		template<typename TFunc>
+		void Each(TFunc func) const {
+			eachInPool(func, FetchedIndices());
+		}
+
+		/* Same as Each, but split the entities into grainSize-long ranges and run them on pool.
+		Every entity is passed to exactly one call, so writing to the passed components is race free. Mut<T> writes are seen by Changed<T> filters and DeltaRecorder as in Each.
+		func must not create/destroy entities or add/remove components, and must be safe to call from several threads.
+		If func throws, the other ranges still run and the first exception is rethrown once they are done.
+		*/
+		template<typename TFunc>
+		void ParallelEach(ThreadPool& pool, TFunc func, size_t grainSize) const {
+			auto entities = m_driver->Entities();
+			size_t size = m_driver->Size();
+			if constexpr (HasMutTerms) {
+				//Mut<T> stamps ticks concurrently, but entities recorded for a DeltaRecorder are collected per range and recorded after the loop.
+				if (isTrackingMut(FetchedIndices())) {
+					grainSize = std::max<size_t>(1, grainSize);
+					std::vector<std::vector<int>> written((size + grainSize - 1) / grainSize);
+					auto markAll = [&]() {
+						for (auto& range : written) {
+							for (auto index : range) {
+								markWritten(index, FetchedIndices());
+							}
+						}
+					};
+					try {
+						pool.ParallelFor(size, grainSize, [&](size_t begin, size_t end) {
+							eachInRangeConcurrent(func, entities, begin, end, &written[begin / grainSize], FetchedIndices());
+						});
+					}
+					catch (...) {
+						//ranges that ran before or besides the one that threw still wrote their components.
+						markAll();
+						throw;
+					}
+					markAll();
+					return;
+				}
+			}
+			pool.ParallelFor(size, grainSize, [&](size_t begin, size_t end) {
+				eachInRangeConcurrent(func, entities, begin, end, nullptr, FetchedIndices());
+			});
+		}
+
+		/* Upper bound of matching entities, which is the size of the smallest pool. */
+		size_t SizeHint() const {
+			return m_driver->Size();
+		}
+	private:
+		friend class World;
+		View(World* world, uint32_t since) :
+			m_world(world),
+			m_since(since),
+			m_tick(world->GetChangeTick()),
+			m_mask(world->GetQueryMask<TComps...>()),
+			m_pools(getPools(world, FetchedIndices())),
+			m_driver(nullptr) {
+			if (m_mask.all.none())
+				throw std::runtime_error("View needs at least one fetched or With component!");
+			for (size_t i = 0; i < m_mask.all.size(); i++)
+			{
+				if (!m_mask.all.test(i))
+					continue;
+				auto candidate = world->getComponentManager(i);
+				if (m_driver == nullptr || candidate->Size() < m_driver->Size())
+					m_driver = candidate;
+			}
+		}
+
+		template<size_t... Is>
+		static typename FetchedTypes<Fetched>::Pools getPools(World* world, std::index_sequence<Is...>) {
+			return typename FetchedTypes<Fetched>::Pools(world->getComponentManager<typename Term<Is>::Component>()...);
+		}
+		template<size_t... Is>
+		bool contains(int index, std::index_sequence<Is...>) const {
+			//without filter terms, checking the fetched pools is enough and warms them up for Fetch.
+			if constexpr (HasFilterTerms) {
+				if (!m_mask.Match(m_world->m_componentActivationTable[index]))
+					return false;
+				return (true && ... && Term<Is>::Match(std::get<Is>(m_pools), index, m_since));
+			}
+			else
+			{
+				return (true && ... && (std::get<Is>(m_pools)->Contains(index) && Term<Is>::Match(std::get<Is>(m_pools), index, m_since)));
+			}
+		}
+		template<size_t... Is>
+		Value get(int index, std::index_sequence<Is...>) const {
+			return Value(Entity(m_world, m_world->m_entities[index]), Term<Is>::Fetch(std::get<Is>(m_pools), index, m_tick)...);
+		}
+		template<typename TFunc, size_t... Is>
+		void eachInPool(TFunc& func, std::index_sequence<Is...>) const {
+			auto driver = m_driver;
+			auto entities = driver->Entities();
+			auto version = driver->GetVersion();
+			for (size_t i = driver->Size(); i > 0;) {
+				//func may have grown(and moved) or shrunk the driving pool.
+				if (driver->GetVersion() != version) {
+					entities = driver->Entities();
+					version = driver->GetVersion();
+					i = std::min(i, driver->Size());
+					if (i == 0)
+						break;
+				}
+				auto index = entities[--i];
+				if (!contains(index, std::index_sequence<Is...>()))
+					continue;
+				func(Entity(m_world, m_world->m_entities[index]), Term<Is>::Fetch(std::get<Is>(m_pools), index, m_tick)...);
+			}
+		}
+
+		template<typename TFunc, size_t... Is>
+		void eachInRangeConcurrent(TFunc& func, const int* entities, size_t begin, size_t end, std::vector<int>* written, std::index_sequence<Is...>) const {
+			for (size_t i = end; i-- > begin;) {
+				auto index = entities[i];
+				if (!contains(index, std::index_sequence<Is...>()))
+					continue;
+				func(Entity(m_world, m_world->m_entities[index]), Term<Is>::FetchConcurrent(std::get<Is>(m_pools), index, m_tick)...);
+				if (written != nullptr)
+					written->push_back(index);
+			}
+		}
+		template<size_t... Is>
+		bool isTrackingMut(std::index_sequence<Is...>) const {
+			return (false || ... || (Term<Is>::IsMut && std::get<Is>(m_pools)->IsTrackingChanges()));
+		}
+		template<size_t... Is>
+		void markWritten(int index, std::index_sequence<Is...>) const {
+			((Term<Is>::IsMut ? std::get<Is>(m_pools)->MarkChanged(index) : void()), ...);
+		}
+
+		World* m_world;
+		uint32_t m_since;	//Changed/Added filters match ticks after it.
+		uint32_t m_tick;	//tick stamped by Mut.
+		QueryMask m_mask;
+		typename FetchedTypes<Fetched>::Pools m_pools;
+		BaseComponentManager* m_driver;
+	};
+}
@@ -1,61 +1,168 @@
 #include "World.h"
+#include <algorithm>
 
-Resecs::World::World() :
-	m_componentActivationTable(1024),
-	m_generation(1024),
-	m_possibleAliveEntities(1024),
+Resecs::World::World(std::pmr::memory_resource* resource) :
+	m_resource(resource),
 	singletonEntity(this,EntityID(0,0))		
 {
+	m_entities.reserve(1024);
+	m_componentActivationTable.reserve(1024);
+	//registration appends to these while other threads may read them, so they must never reallocate.
+	m_componentManagers.reserve(MAX_COMPONENT_COUNT);
+	m_componentEvents.reserve(MAX_COMPONENT_COUNT);
+	m_eventsDispatchedOf.reserve(MAX_COMPONENT_COUNT);
 	singletonEntity = Create();
 }
 
 Resecs::Entity Resecs::World::Create() {
-	int loopCount = 0;
-	while (m_alive[m_creationIndex])
+	EntityID entityID;
+	if (m_freeListHead != NullIndex) {
+		//reuse a dead slot.
+		auto index = m_freeListHead;
+		m_freeListHead = m_entities[index].index;
+		m_entities[index].index = index;
+		entityID = m_entities[index];
+	}
+	else
 	{
-		if (loopCount++ > MAX_ENTITY_COUNT) {
-			throw std::overflow_error("Max entity count reached!!!");
-		}
-		m_creationIndex = (m_creationIndex + 1) % MAX_ENTITY_COUNT;
+		entityID = EntityID(m_entities.size(), m_generationFloor);
+		m_entities.push_back(entityID);
+		m_componentActivationTable.emplace_back();
 	}
-	EnlargeVectorToFit(m_generation, m_creationIndex);
-	EnlargeVectorToFit(m_componentActivationTable, m_creationIndex);
 
-	m_alive[m_creationIndex] = true;
-	auto entityID = EntityID(m_creationIndex, m_generation[m_creationIndex]);
-	m_possibleAliveEntities.push_back(entityID);
 	m_aliveEntityCount++;
 	m_componentActivationTable[entityID.index].reset();	//clean activation table.
+	OnEntityCreated.Invoke(entityID);
+	OnEntitiesCreated.Invoke(&entityID, 1);
 	return Entity(this, entityID);
 }
 
+void Resecs::World::createEntities(size_t count, std::vector<Entity>& entities, std::pmr::vector<int>& indices) {
+	entities.reserve(entities.size() + count);
+	indices.reserve(indices.size() + count);
+	std::pmr::vector<EntityID> created(m_resource);
+	created.reserve(count);
+	//reuse dead slots first, like Create().
+	while (created.size() < count && m_freeListHead != NullIndex) {
+		auto index = m_freeListHead;
+		m_freeListHead = m_entities[index].index;
+		m_entities[index].index = index;
+		m_componentActivationTable[index].reset();
+		created.push_back(m_entities[index]);
+	}
+	//then grow the slots once for the rest, new activation bitsets are empty.
+	auto begin = m_entities.size();
+	auto required = begin + count - created.size();
+	if (required > m_entities.capacity()) {
+		auto capacity = std::max(required, m_entities.capacity() * 2);
+		m_entities.reserve(capacity);
+		m_componentActivationTable.reserve(capacity);
+	}
+	m_componentActivationTable.resize(required);
+	for (size_t index = begin; index < required; index++)
+	{
+		m_entities.push_back(EntityID(index, m_generationFloor));
+		created.push_back(m_entities.back());
+	}
+	m_aliveEntityCount += count;
+
+	for (auto entity : created) {
+		entities.push_back(Entity(this, entity));
+		indices.push_back(entity.index);
+	}
+	if (OnEntityCreated.HasListeners()) {
+		for (auto entity : created) {
+			OnEntityCreated.Invoke(entity);
+		}
+	}
+	OnEntitiesCreated.Invoke(created.data(), created.size());
+}
+
 /* Iterate all entities. */
 void Resecs::World::Each(typename Identity<std::function<void(Entity)>>::type func) {
-	/* Remove all dead entities first. */
-	m_possibleAliveEntities.erase(std::remove_if(m_possibleAliveEntities.begin(), m_possibleAliveEntities.end(),
-		[=](EntityID& id) {
-		return !this->CheckEntityAlive(id);
-	}
-	), m_possibleAliveEntities.end());
-	for (auto id : m_possibleAliveEntities) {
-		auto entityHandle = GetEntityHandle(id);
-		func(entityHandle);
+	auto count = m_entities.size();
+	for (size_t i = 0; i < count; i++)
+	{
+		if (m_entities[i].index == i)
+			func(GetEntityHandle(m_entities[i]));
 	}
 }
 
+Resecs::ThreadPool & Resecs::World::GetThreadPool() {
+	if (m_threadPool == nullptr)
+		return ThreadPool::Default();
+	return *m_threadPool;
+}
+
+void Resecs::World::SetThreadPool(ThreadPool * pool) {
+	m_threadPool = pool;
+}
+
+uint32_t Resecs::World::GetChangeTick() {
+	return m_changeTick;
+}
+
+uint32_t Resecs::World::IncrementChangeTick() {
+	return m_changeTick.fetch_add(1);
+}
+
 /* Current alive entities */
 int Resecs::World::EntityCount() {
 	return m_aliveEntityCount;
 }
 
+void Resecs::World::Compact() {
+	//drop dead slots at the end, the next entity in a dropped slot starts above every generation it had.
+	auto size = m_entities.size();
+	while (size > 1 && m_entities[size - 1].index != size - 1) {
+		m_generationFloor = std::max(m_generationFloor, m_entities[size - 1].generation);
+		size--;
+	}
+	if (size < m_entities.size()) {
+		//relink the free list without the dropped slots, keeping its order.
+		EntityIndex_t* link = &m_freeListHead;
+		for (auto index = m_freeListHead; index != NullIndex; index = m_entities[index].index) {
+			if (index < size) {
+				*link = index;
+				link = &m_entities[index].index;
+			}
+		}
+		*link = NullIndex;
+		m_entities.resize(size);
+		m_componentActivationTable.resize(size);
+	}
+	m_entities.shrink_to_fit();
+	m_componentActivationTable.shrink_to_fit();
+	m_eventBuffer.clear();
+	m_eventBuffer.shrink_to_fit();
+	for (auto& pool : m_componentManagers) {
+		if (pool->GetOwner() == nullptr)
+			pool->SortByEntity();
+		pool->Shrink();
+	}
+}
+
+Resecs::WorldStats Resecs::World::GetStats() {
+	WorldStats stats;
+	stats.entityCount = m_aliveEntityCount;
+	stats.entitySlots = m_entities.size();
+	stats.freeSlots = m_entities.size() - m_aliveEntityCount;
+	stats.groupCount = *m_groupCount;
+	stats.eventsDispatched = m_eventsDispatched;
+	stats.eventBatches = m_eventBatches;
+	for (size_t i = 0; i < m_componentManagers.size(); i++)
+	{
+		auto pool = m_componentManagers[i].get();
+		stats.pools.push_back(PoolStats{ static_cast<int>(i), pool->TypeName(), pool->Size(), pool->Capacity(), pool->IndexSize(), m_eventsDispatchedOf[i] });
+	}
+	return stats;
+}
+
 bool Resecs::World::CheckEntityAlive(EntityID toCheck) {
-	if (toCheck.index >= m_alive.size()) {
+	if (toCheck.index >= m_entities.size()) {
 		return false;
 	}
-	if (m_alive[toCheck.index] && m_generation[toCheck.index] == toCheck.generation) {
-		return true;
-	}
-	return false;
+	return m_entities[toCheck.index] == toCheck;
 }
 
 Resecs::Entity Resecs::World::GetEntityHandle(EntityID id) {
@@ -63,14 +170,31 @@ Resecs::Entity Resecs::World::GetEntityHandle(EntityID id) {
 }
 
 void Resecs::World::destroyEntity(EntityID id) {
+	if (!CheckEntityAlive(id)) {
+		throw std::runtime_error("This entity is already destroyed!");
+	}
+	//remove all components at once, events are fired before components are released, see RemoveComponent().
+	std::pmr::vector<ComponentEventArgs> events(m_resource);
+	events.swap(m_eventBuffer);
 	for (size_t i = 0; i < m_componentManagers.size(); i++)
 	{
-		if (HasComponent(id, i))
-			RemoveComponent(id, i);
+		if (getComponentActivationStatus(id, i)) {
+			setComponentActivationStatus(id, i, false);
+			events.push_back(ComponentEventArgs(ComponentEventType::Removed, id, i));
+		}
 	}
-	m_generation[id.index]++;
-	m_alive[id.index] = false;
+	notifyComponentsChanged(events);
+	for (auto& arg : events) {
+		getComponentManager(arg.componentTypeIndex)->Release(id.index);
+	}
+	events.clear();
+	m_eventBuffer.swap(events);
+
+	//push the slot to free list.
+	m_entities[id.index] = EntityID(m_freeListHead, id.generation + 1);
+	m_freeListHead = id.index;
 	m_aliveEntityCount--;
+	OnEntityDestroyed.Invoke(id);
 }
 
 void Resecs::World::RemoveComponent(EntityID entity, int componentIndex) {
@@ -80,14 +204,52 @@ void Resecs::World::RemoveComponent(EntityID entity, int componentIndex) {
 	if (!HasComponent(entity, componentIndex)) {
 		throw std::runtime_error("This entity doesn't have this type of component!");
 	}
-	auto cm = getComponentManager(componentIndex);
-	cm->Release(entity.index);
-	getComponentActivationStatus(entity, componentIndex) = false;
-	OnComponentChanged.Invoke(ComponentEventArgs(
+	//the component is released after the event, so listeners(e.g. owning groups) still see it in the pool.
+	setComponentActivationStatus(entity, componentIndex, false);
+	notifyComponentChanged(ComponentEventArgs(
 		ComponentEventType::Removed,
 		entity,
 		componentIndex
 	));
+	auto cm = getComponentManager(componentIndex);
+	cm->Release(entity.index);
+}
+
+void Resecs::World::notifyComponentChanged(const ComponentEventArgs & arg) {
+#ifdef RESECS_PROFILING
+	m_eventsDispatched++;
+	m_eventBatches++;
+	m_eventsDispatchedOf[arg.componentTypeIndex]++;
+#endif
+	OnComponentChanged.Invoke(arg);
+	m_componentEvents[arg.componentTypeIndex]->Invoke(&arg, 1);
+}
+
+void Resecs::World::notifyComponentsChanged(std::pmr::vector<ComponentEventArgs>& args) {
+	for (auto& arg : args) {
+		OnComponentChanged.Invoke(arg);
+	}
+	auto byType = [](const ComponentEventArgs& a, const ComponentEventArgs& b) {
+		return a.componentTypeIndex < b.componentTypeIndex;
+	};
+	if (!std::is_sorted(args.begin(), args.end(), byType))
+		std::stable_sort(args.begin(), args.end(), byType);
+	for (size_t begin = 0; begin < args.size();) {
+		auto end = begin + 1;
+		while (end < args.size() && args[end].componentTypeIndex == args[begin].componentTypeIndex)
+			end++;
+#ifdef RESECS_PROFILING
+		m_eventsDispatched += end - begin;
+		m_eventBatches++;
+		m_eventsDispatchedOf[args[begin].componentTypeIndex] += end - begin;
+#endif
+		m_componentEvents[args[begin].componentTypeIndex]->Invoke(&args[begin], end - begin);
+		begin = end;
+	}
+}
+
+Resecs::ComponentBatchEventDelegate & Resecs::World::OnComponentChangedOf(int componentIndex) {
+	return *m_componentEvents[componentIndex];
 }
 
 bool Resecs::World::HasComponent(EntityID entity, int componentIndex) {
@@ -106,10 +268,12 @@ Resecs::ComponentActivationBitset & Resecs::World::GetActivationTableFor(EntityI
 
 //first dim is EntityID, second dim is componentID
 
-Resecs::ComponentActivationBitset::reference Resecs::World::getComponentActivationStatus(EntityID entity, int componentIndex) {
-	EnlargeVectorToFit(m_componentActivationTable, entity.index);
-	auto& vec = m_componentActivationTable[entity.index];
-	return vec[componentIndex];
+bool Resecs::World::getComponentActivationStatus(EntityID entity, int componentIndex) {
+	return m_componentActivationTable[entity.index].test(componentIndex);
+}
+
+void Resecs::World::setComponentActivationStatus(EntityID entity, int componentIndex, bool value) {
+	m_componentActivationTable[entity.index].set(componentIndex, value);
 }
 
 BaseComponentManager * Resecs::World::getComponentManager(int componentIndex) {
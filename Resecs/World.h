@@ -7,10 +7,19 @@
 #include <unordered_map>
 #include <typeindex>
 #include <exception>
-#include <bitset>
+#include <string>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <atomic>
 
 #include "Utils\Signal.hpp"
+#include "Utils\AlignedAllocator.hpp"
+#include "Utils\LookupTable.hpp"
+#include "Utils\ThreadPool.hpp"
 #include "Utils\Common.hpp"
+#include "Utils\Bitset.hpp"
+#include "Utils\Profiler.hpp"
 #include "Component.hpp"
 #include "EntityID.hpp"
 #include "ComponentManager.h"
@@ -28,14 +37,30 @@ namespace Resecs {
 			return AllTrue(vals...);
 		return false;
 	}
-	const static int MAX_COMPONENT_COUNT = 2 << 8;
+	template <typename... T>
+	constexpr bool AnyTrue(T... vals) {
+		return (false || ... || vals);
+	}
+	/* Whether no type is listed twice. */
+	template <typename... T>
+	struct AreDistinct : std::true_type {};
+	template <typename T, typename... U>
+	struct AreDistinct<T, U...> : std::bool_constant<!AnyTrue(std::is_same<T, U>::value...) && AreDistinct<U...>::value> {};
+	/* Max count of component types in a World, which is the width of entity signatures.
+	Every entity pays MAX_COMPONENT_COUNT / 8 bytes, so keep it close to the count of component types actually used(64/128/256...).
+	*/
+#ifndef RESECS_MAX_COMPONENT_TYPES
+#define RESECS_MAX_COMPONENT_TYPES 64
+#endif
+	const static int MAX_COMPONENT_COUNT = RESECS_MAX_COMPONENT_TYPES;
 
-	using ComponentActivationBitset = std::bitset<MAX_COMPONENT_COUNT>;
+	using ComponentActivationBitset = Bitset<MAX_COMPONENT_COUNT>;
 
 	enum class ComponentEventType
 	{
 		Added,
 		Removed,
+		Updated,	//edited in place through Entity::Patch/Replace, the entity keeps the component.
 	};
 
 	struct ComponentEventArgs
@@ -56,80 +81,247 @@ namespace Resecs {
 	};
 
 	using ComponentEventDelegate = Signal<ComponentEventArgs>;
+	using EntityEventDelegate = Signal<EntityID>;
+	/* Entity events passed as an array of count entities. */
+	using EntityBatchEventDelegate = Signal<const EntityID*, size_t>;
+	/* Events of a single component type, passed as an array of count events. */
+	using ComponentBatchEventDelegate = Signal<const ComponentEventArgs*, size_t>;
+
+	/* Compiled component filter of a View or Group. */
+	struct QueryMask {
+		ComponentActivationBitset all;	//must have all of them.
+		ComponentActivationBitset none;	//must have none of them.
+		ComponentActivationBitset any;	//must have one of them, unless empty.
+		bool Match(const ComponentActivationBitset& components) const {
+			return components.Contains(all) && !components.Intersects(none) && (any.none() || components.Intersects(any));
+		}
+		/* Every component type the filter depends on. */
+		ComponentActivationBitset Dependencies() const {
+			return all | none | any;
+		}
+	};
+
+	/* Snapshot of a component pool, see World::GetStats(). */
+	struct PoolStats {
+		int componentIndex;
+		std::string typeName;
+		size_t size;	//live components, pools are packed so there's no dead slot.
+		size_t capacity;	//components the pool holds without reallocation.
+		size_t indexSize;	//length of its entity index to position map.
+		uint64_t eventsDispatched;	//added/removed events of this type, only counted with RESECS_PROFILING.
+	};
+	/* Snapshot of the state of a World, see World::GetStats(). */
+	struct WorldStats {
+		int entityCount;	//alive entities, including the one holding singleton components.
+		size_t entitySlots;	//alive and dead entity slots.
+		size_t freeSlots;	//length of the free list.
+		size_t groupCount;
+		uint64_t eventsDispatched;	//added/removed events, only counted with RESECS_PROFILING.
+		uint64_t eventBatches;	//calls of OnComponentChangedOf signals, only counted with RESECS_PROFILING.
+		std::vector<PoolStats> pools;	//one per registered component type.
+	};
+
+	template<typename... TComps>
+	class View;
+	template<typename T>
+	struct QueryTerm;
+	template<typename... TComps>
+	class ChunkQuery;
 
 	class World {
+		std::pmr::memory_resource* m_resource;	//declared first, everything below allocates from it.
 	/* main interface. */
 	public:
 		friend Entity;
-		World();
+		friend class CommandBuffer;
+		friend class Snapshot;
+		template<typename... TComps>
+		friend class DeltaRecorder;
+		friend class Group;
+		template<typename... TComps>
+		friend class Resecs::View;
+		template<typename... TComps>
+		friend class ChunkQuery;
+		/* Every container of the World(entity slots, pools, groups, signal connections, type maps) allocates from resource.
+		Give it an Arena(see Utils/Arena.hpp) to keep the World off the global heap, a monotonic one makes destroying the World nearly free:
+		Arena arena(64 << 20, std::pmr::get_default_resource(), Arena::Mode::Monotonic);
+		auto world = new World(&arena);
+		...
+		delete world;	//only components with a non-trivial destructor are visited, nothing is freed.
+		arena.Reset();
+		resource must outlive the World and everything created from it(groups, views, collectors).
+		*/
+		explicit World(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+		std::pmr::memory_resource* GetMemoryResource() const {
+			return m_resource;
+		}
+		/* Fired for every entity created(CreateMany included), and destroyed after its components are removed. */
+		EntityEventDelegate OnEntityCreated{ m_resource };
+		EntityEventDelegate OnEntityDestroyed{ m_resource };
+		/* Same as OnEntityCreated, but CreateMany() fires it once for all of its entities. */
+		EntityBatchEventDelegate OnEntitiesCreated{ m_resource };
 		Entity Create();
+		/* Create count entities, each with a copy of components.
+		Entity slots and component pools grow once, and listeners of OnComponentChangedOf get one batched event per component type.
+		Much faster than Create() followed by Add() for spawning lots of entities.
+		*/
+		template<typename... TComps>
+		std::vector<Entity> CreateMany(size_t count, const TComps&... components) {
+			static_assert(!AnyTrue(std::is_base_of<ISingletonComponent, TComps>::value...), "Can't add singleton to a normal entity!");
+			static_assert(AreDistinct<TComps...>::value, "A component type is listed more than once!");
+			std::vector<Entity> entities;
+			std::pmr::vector<int> indices(m_resource);
+			createEntities(count, entities, indices);
+			std::pmr::vector<ComponentEventArgs> events(m_resource);
+			events.reserve(count * sizeof...(TComps));
+			(addComponents(indices, components, events), ...);
+			notifyComponentsChanged(events);
+			return entities;
+		}
 		template <typename T>
 		struct Identity {
 			typedef T type;
 		};
-		/* Iterate all entities that has TSubComps, then do func() */
-		template<typename... TSubComps>
-		void Each(typename Identity<std::function<void(Entity, TSubComps*...)>>::type func) {
-			/* Remove all dead entities first. */
-			m_possibleAliveEntities.erase(std::remove_if(m_possibleAliveEntities.begin(), m_possibleAliveEntities.end(),
-				[=](EntityID& id) {
-				return !this->CheckEntityAlive(id);
-			}
-			), m_possibleAliveEntities.end());
-			ComponentActivationBitset componentFilter = ConvertComponentTypesToMask<TSubComps>();
-
-			for (auto id : m_possibleAliveEntities) {
-				auto entityHandle = GetEntityHandle(id);
-				if ((GetActivationTableFor(entityHandle.entityID) & componentFilter) == componentFilter)
-					func(entityHandle, GetComponent<TSubComps>(id.index)...);
-			}
+		/* Create a view over all entities that has TComps. see View.h
+		Changed<T>/Added<T> filters match components written/added after tick since.
+		*/
+		template<typename... TComps>
+		Resecs::View<TComps...> View(uint32_t since = 0) {
+			return Resecs::View<TComps...>{ this, since };
+		}
+		/* Iterate all entities that has TFirst and TRest, then do func(Entity, TFirst*, TRest*...)
+		Destroying the current entity or removing its components is allowed, so is creating entities and adding components, see View.
+		*/
+		template<typename TFirst, typename... TRest, typename TFunc>
+		void Each(TFunc func, uint32_t since = 0) {
+			View<TFirst, TRest...>(since).Each(func);
 		}
+		/* Same as Each, but run on multiple threads, see View::ParallelEach.
+		Entities are split into grainSize-long ranges, each range is a task for the thread pool.
+		*/
+		template<typename TFirst, typename... TRest, typename TFunc>
+		void ParallelEach(TFunc func, size_t grainSize = 1024, uint32_t since = 0) {
+			View<TFirst, TRest...>(since).ParallelEach(GetThreadPool(), func, grainSize);
+		}
+		/* Tick stamped on components when they're added or written through GetMut()/Mut<T>. */
+		uint32_t GetChangeTick();
+		/* Advance the change tick and return the previous one, everything added/written after the call is newer than the returned tick.
+		A system calls it when it starts and keeps the result, next time it passes the kept tick as since to see what changed in between(including its own writes):
+		auto since = lastRun;
+		lastRun = world.IncrementChangeTick();
+		world.Each<Changed<Transform>>(func, since);
+		Safe to call from systems running at the same time, every call returns a different tick.
+		*/
+		uint32_t IncrementChangeTick();
+		/* Call func(size_t count, const EntityID* entities, components...) for chunks of entities having the component of every term.
+		A term T is passed as a const T* array, Mut<T> as a T* array and marked as changed like in a View:
+		world.ForEachChunk<Mut<Transform>, Velocity>([](size_t count, const EntityID* entities, Transform* pTrans, const Velocity* pVel) {...});
+		Each call gets count entities, every array is contiguous and aligned to ChunkAlignment, so func can run a vectorized loop over them.
+		Chunks are passed in place when the pools line up(owning groups, CreateMany), otherwise the components are copied in and out, see ChunkQuery.
+		func must not create/destroy entities or add/remove components.
+		*/
+		template<typename... TTerms, typename TFunc>
+		void ForEachChunk(TFunc func, size_t chunkSize = 1024) {
+			ChunkQuery<TTerms...>(this, chunkSize).Run(func);
+		}
+		/* Thread pool used by ParallelEach, ThreadPool::Default() if not set. */
+		ThreadPool& GetThreadPool();
+		void SetThreadPool(ThreadPool* pool);
 		/* Iterate all entities. */
 		void Each(typename Identity<std::function<void(Entity)>>::type func);
 		/* Current alive entities */
 		int EntityCount();
+		/* Give memory back after a spike of entities.
+		Dead entity slots at the end of the table are dropped, pools are sorted by entity index(except those owned by a group) and shrunk to fit.
+		Entity handles stay valid and stale ones stay dead, but component pointers are invalidated.
+		It walks every slot and pool, so call it at quiet points(e.g. after a level unloads). A mirror World fed by a DeltaRecorder must compact at the same point.
+		*/
+		void Compact();
+		/* Entity, pool and group counts, plus event counters if RESECS_PROFILING is defined.
+		It walks every pool, so call it once in a while(e.g. for a debug overlay), not per entity.
+		*/
+		WorldStats GetStats();
 	/*Entity ID management*/
 	public:
 		bool CheckEntityAlive(EntityID toCheck);
 		Entity GetEntityHandle(EntityID id);
-		const static int MAX_ENTITY_COUNT = 2 << 20;	//max entity count.
 	private:
 		void destroyEntity(EntityID id);
-		std::vector<int> m_generation;
-		std::bitset<MAX_ENTITY_COUNT> m_alive;
-		size_t m_creationIndex = 0;
+		/* Create count empty entities, see CreateMany().
+		Dead slots are reused first, then the slot arrays grow once for the rest. Creation events are fired after all of them exist.
+		*/
+		void createEntities(size_t count, std::vector<Entity>& entities, std::pmr::vector<int>& indices);
+		/* Entity slots, which also form an intrusive free list.
+		An alive slot i holds EntityID(i, generation).
+		A dead slot holds the index of the next dead slot(or NullIndex) and the generation its next entity will get.
+		*/
+		std::pmr::vector<EntityID> m_entities{ m_resource };
+		const static EntityIndex_t NullIndex = ~EntityIndex_t(0);
+		EntityIndex_t m_freeListHead = NullIndex;
+		int m_generationFloor = 0;	//generation of new slots, above the generations of slots dropped by Compact(), so stale handles can't come back alive.
 		int m_aliveEntityCount = 0;
-		std::vector<EntityID> m_possibleAliveEntities;
 		Entity singletonEntity;
+		ThreadPool* m_threadPool = nullptr;
+		std::atomic<uint32_t> m_changeTick{ 1 };	//systems running at the same time may advance it, see IncrementChangeTick().
+		std::shared_ptr<size_t> m_groupCount = std::make_shared<size_t>(0);	//maintained by Group, which keeps a weak_ptr to it to tell whether the world is gone.
+		//counted only with RESECS_PROFILING, but always declared so the layout doesn't depend on it.
+		uint64_t m_eventsDispatched = 0;
+		uint64_t m_eventBatches = 0;
+		std::pmr::vector<uint64_t> m_eventsDispatchedOf{ m_resource };	//per component type.
 	
 	/*Component management.*/
 	public:
-		ComponentEventDelegate OnComponentChanged;
+		/* Fired for every component added/removed. */
+		ComponentEventDelegate OnComponentChanged{ m_resource };
+		/* Fired only for components of type componentIndex, bulk operations fire it once with all their events.
+		Prefer it to OnComponentChanged if only a few types are interesting(e.g. Group), since listeners aren't called for other types.
+		*/
+		ComponentBatchEventDelegate& OnComponentChangedOf(int componentIndex);
+		template<typename T>
+		ComponentBatchEventDelegate& OnComponentChangedOf() {
+			return OnComponentChangedOf(ConvertComponentTypeToIndex<T>());
+		}
+		/* Index of T in this World, T is registered on first use.
+		Indices are assigned in registration order, so they differ between Worlds.
+		Safe to call from several threads(e.g. systems of a ParallelFeature), registration takes a lock but lookups don't.
+		*/
 		template<typename T>
 		int ConvertComponentTypeToIndex() {
-			getComponentManager<T>();	//make sure T is registered.
-			return m_componentToIndex[typeid(T)];
+			auto typeID = ComponentTypeID<T>();
+			int index = m_componentIndexOfType.Get(typeID);
+			if (index != InvalidComponentIndex)
+				return index;
+			return registerComponentType<T>(typeID);
+		}
+		/* Filter of a query on TTerms(e.g. <Position, Without<Disabled>>), compiled once per World and cached.
+		Safe to call from several threads like ConvertComponentTypeToIndex().
+		*/
+		template<typename... TTerms>
+		const QueryMask& GetQueryMask() {
+			auto queryID = queryTypeID<TTerms...>();
+			auto cached = m_queryMaskOf.Get(queryID);
+			if (cached != nullptr)
+				return *cached;
+			QueryMask mask;
+			(QueryTerm<TTerms>::AddToMask(*this, mask), ...);
+			std::lock_guard<std::mutex> lock(m_registryMutex);
+			//another thread may have compiled it meanwhile.
+			cached = m_queryMaskOf.Get(queryID);
+			if (cached != nullptr)
+				return *cached;
+			m_queryMasks.push_back(NewWithResource<QueryMask>(m_resource, mask));
+			m_queryMaskOf.Set(queryID, m_queryMasks.back().get());
+			return *m_queryMasks.back();
 		}
 		template<typename... TComps>
 		ComponentActivationBitset ConvertComponentTypesToMask() {
-			ComponentActivationBitset result;
-			convertComponentTypesToMaskInternal<TComps>(result);
-			return result;
-		}
-	private:
-		template<typename T, typename U,typename... Rest>
-		void convertComponentTypesToMaskInternal(ComponentActivationBitset& bs) {
-			convertComponentTypesToMaskInternal<T>(bs);
-			convertComponentTypesToMaskInternal<U,Rest...>(bs);
-		}
-		template<typename TComp>
-		void convertComponentTypesToMaskInternal(ComponentActivationBitset& bs) {
-			bs.set(ConvertComponentTypeToIndex<TComp>());
+			return GetQueryMask<TComps...>().all;
 		}
 	private:
 		//Only friend class Entity use these.
-		template<typename T>
-		T* AddComponent(EntityID entity) {
+		/* Construct T of entity from args, then fire Added. */
+		template<typename T, typename... TArgs>
+		ComponentPointer<T> AddComponent(EntityID entity, TArgs&&... args) {
 			int compIndex = ConvertComponentTypeToIndex<T>();
 			if (!CheckEntityAlive(entity)) {
 				throw std::runtime_error("This entity is already destroyed!");
@@ -138,17 +330,27 @@ namespace Resecs {
 				throw std::runtime_error("This entity already has this component!");
 			}
 			auto cm = getComponentManager<T>();
-			cm->Create(entity.index);
-			getComponentActivationStatus(entity, compIndex) = true;
-			OnComponentChanged.Invoke(ComponentEventArgs(
+			cm->Emplace(entity.index, m_changeTick, std::forward<TArgs>(args)...);
+			setComponentActivationStatus(entity, compIndex, true);
+			notifyComponentChanged(ComponentEventArgs(
 				ComponentEventType::Added,
 				entity,
 				compIndex
 			));
 			return cm->Get(entity.index);
 		}
+		/* Add a copy of value to every fresh entity in indices, and collect the events. */
 		template<typename T>
-		T* GetComponent(EntityID entity) {
+		void addComponents(const std::pmr::vector<int>& indices, const T& value, std::pmr::vector<ComponentEventArgs>& events) {
+			int compIndex = ConvertComponentTypeToIndex<T>();
+			getComponentManager<T>()->CreateMany(indices.data(), indices.size(), value, m_changeTick);
+			for (auto index : indices) {
+				m_componentActivationTable[index].set(compIndex);
+				events.push_back(ComponentEventArgs(ComponentEventType::Added, m_entities[index], compIndex));
+			}
+		}
+		template<typename T>
+		ComponentPointer<T> GetComponent(EntityID entity) {
 			int compIndex = ConvertComponentTypeToIndex<T>();
 			if (!CheckEntityAlive(entity)) {
 				throw std::runtime_error("This entity is already destroyed!");
@@ -159,25 +361,64 @@ namespace Resecs {
 			auto cm = getComponentManager<T>();
 			return cm->Get(entity.index);
 		}
+		/* Same as GetComponent, but mark the component as changed. */
+		template<typename T>
+		ComponentPointer<T> GetComponentMut(EntityID entity) {
+			if (GetComponent<T>(entity) == nullptr)
+				return nullptr;
+			return getComponentManager<T>()->GetMut(entity.index, m_changeTick);
+		}
+		/* Call func(T&) on T of entity, mark it as changed, then fire Updated. */
+		template<typename T, typename TFunc>
+		ComponentPointer<T> PatchComponent(EntityID entity, TFunc& func) {
+			auto p = GetComponentMut<T>(entity);
+			if (p == nullptr) {
+				throw std::runtime_error("This entity doesn't have this type of component!");
+			}
+			if constexpr (IsSoAComponent<T>::value) {
+				//fields are gathered, edited and scattered back.
+				T value = *p;
+				func(value);
+				*p = value;
+			}
+			else
+			{
+				func(*p);
+			}
+			notifyComponentChanged(ComponentEventArgs(
+				ComponentEventType::Updated,
+				entity,
+				ConvertComponentTypeToIndex<T>()
+			));
+			return p;
+		}
 		void RemoveComponent(EntityID entity, int componentIndex);
 		bool HasComponent(EntityID entity, int componentIndex);
+		void notifyComponentChanged(const ComponentEventArgs& arg);
+		/* Notify a batch of events, listeners of each type are called once. The order of events may be changed. */
+		void notifyComponentsChanged(std::pmr::vector<ComponentEventArgs>& args);
 	
 		/*Singleton component manipulation*/
 	public:
 		template<typename T>
-		T* Add(T val) {
+		ComponentPointer<T> Add(T val) {
 			static_assert(std::is_base_of<ISingletonComponent, T>::value, "Can't manipulate a non-singleton component directly to World");
 			return singletonEntity.Add<T>(val);
 		}
 		template<typename T>
-		T* Get() {
+		ComponentPointer<T> Get() {
 			static_assert(std::is_base_of<ISingletonComponent, T>::value, "Can't manipulate a non-singleton component directly to World");
 			return singletonEntity.Get<T>();
 		}
 		template<typename T>
-		T* Replace(T val) {
+		ComponentPointer<T> Replace(T val) {
 			static_assert(std::is_base_of<ISingletonComponent, T>::value, "Can't manipulate a non-singleton component directly to World");
-			return singletonEntity.Replace<T>(val);
+			return singletonEntity.Replace<T>(std::move(val));
+		}
+		template<typename T, typename TFunc>
+		ComponentPointer<T> Patch(TFunc func) {
+			static_assert(std::is_base_of<ISingletonComponent, T>::value, "Can't manipulate a non-singleton component directly to World");
+			return singletonEntity.Patch<T>(func);
 		}
 		template<typename T>
 		bool Has() {
@@ -192,35 +433,64 @@ namespace Resecs {
 		
 		ComponentActivationBitset& GetActivationTableFor(EntityID entity);
 	private:
-		std::unordered_map<std::type_index, int> m_componentToIndex;
-		std::vector<std::unique_ptr<BaseComponentManager>> m_componentManagers;
-		std::vector<ComponentActivationBitset> m_componentActivationTable;	//first dim is EntityID, second dim is componentID
-		ComponentActivationBitset::reference getComponentActivationStatus(EntityID entity, int componentIndex);
+		static size_t nextQueryTypeID() {
+			static std::atomic<size_t> counter(0);
+			return counter++;
+		}
+		/* Process-wide ID of a query type, see GetQueryMask(). */
+		template<typename... TTerms>
+		static size_t queryTypeID() {
+			static const size_t id = nextQueryTypeID();
+			return id;
+		}
+		/* Taken to register a component type or compile a query mask.
+		Lookups go through LookupTables without it, and the vectors below never reallocate(reserved for MAX_COMPONENT_COUNT types), so they can be read meanwhile.
+		*/
+		std::mutex m_registryMutex;
+		std::pmr::vector<ResourcePtr<QueryMask>> m_queryMasks{ m_resource };	//compiled masks, in compilation order.
+		LookupTable<const QueryMask*> m_queryMaskOf{ nullptr, m_resource };	//map query type ID to its mask in this World.
+		const static int InvalidComponentIndex = -1;
+		LookupTable<int> m_componentIndexOfType{ InvalidComponentIndex, m_resource };	//map ComponentTypeID to index in this World.
+		std::pmr::vector<ResourcePtr<BaseComponentManager>> m_componentManagers{ m_resource };
+		std::pmr::vector<ResourcePtr<ComponentBatchEventDelegate>> m_componentEvents{ m_resource };	//OnComponentChangedOf for each component type.
+		std::pmr::vector<ComponentEventArgs> m_eventBuffer{ m_resource };	//reused by bulk operations to collect events.
+		std::pmr::vector<ComponentActivationBitset> m_componentActivationTable{ m_resource };	//first dim is EntityID, second dim is componentID
+		bool getComponentActivationStatus(EntityID entity, int componentIndex);
+		void setComponentActivationStatus(EntityID entity, int componentIndex, bool value);
 
 		int m_maxComponentTypeCount = 0;	//used to assign unique index to every new component type.
 		template<typename T>
-		ComponentManager<T>* getComponentManager() {
-			auto compIndexIte = m_componentToIndex.find(typeid(T));
-			int compIndex;
-			if (compIndexIte == m_componentToIndex.end()) {
-				//Create cm.
-				if (std::is_base_of<ISingletonComponent, T>::value) {
-					this->m_componentManagers.emplace_back(std::make_unique<ComponentManager<T>>(1));		//give a initial size of one.
-				}
-				else
-				{
-					this->m_componentManagers.emplace_back(std::make_unique<ComponentManager<T>>());
-				}
-				//AddComponent type->int map.
-				compIndex = m_maxComponentTypeCount;
-				m_componentToIndex[typeid(T)] = m_maxComponentTypeCount++;
+		int registerComponentType(size_t typeID) {
+			std::lock_guard<std::mutex> lock(m_registryMutex);
+			//another thread may have registered it meanwhile.
+			int registered = m_componentIndexOfType.Get(typeID);
+			if (registered != InvalidComponentIndex)
+				return registered;
+			if (m_maxComponentTypeCount >= MAX_COMPONENT_COUNT) {
+				throw std::overflow_error("Max component type count reached!!! Define RESECS_MAX_COMPONENT_TYPES to a larger value.");
+			}
+			//Create cm.
+			if (std::is_base_of<ISingletonComponent, T>::value) {
+				this->m_componentManagers.emplace_back(NewWithResource<ComponentManager<T>, BaseComponentManager>(m_resource, 1, m_resource));		//give a initial size of one.
 			}
 			else
 			{
-				compIndex = compIndexIte->second;
+				this->m_componentManagers.emplace_back(NewWithResource<ComponentManager<T>, BaseComponentManager>(m_resource, 1024, m_resource));
 			}
-			return static_cast<ComponentManager<T>*>(m_componentManagers[compIndex].get());
+			this->m_componentEvents.emplace_back(NewWithResource<ComponentBatchEventDelegate>(m_resource, m_resource));
+			this->m_eventsDispatchedOf.push_back(0);
+			//publish the index last, the pool and signal are visible to whoever sees it.
+			m_componentIndexOfType.Set(typeID, m_maxComponentTypeCount);
+			return m_maxComponentTypeCount++;
+		}
+		template<typename T>
+		ComponentManager<T>* getComponentManager() {
+			return static_cast<ComponentManager<T>*>(m_componentManagers[ConvertComponentTypeToIndex<T>()].get());
 		}
 		BaseComponentManager* getComponentManager(int componentIndex);
 	};
-}
\ No newline at end of file
+}
+
+//View needs the complete World.
+#include "View.h"
+#include "Chunk.h"
\ No newline at end of file
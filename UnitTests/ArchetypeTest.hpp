@@ -0,0 +1,139 @@
+#pragma once
+#include <gtest\gtest.h>
+#include "Resecs\ArchetypeWorld.h"
+#include "EntityTest.hpp"
+
+using namespace Resecs;
+
+TEST(ArchetypeTest, AddRemoveComponentTest) {
+	ArchetypeWorld testWorld;
+	auto entity = testWorld.Create();
+	ASSERT_FALSE(testWorld.Has<PositionComponent>(entity));
+	testWorld.Add(entity, PositionComponent(0, 0, 1));
+	testWorld.Add(entity, VelocityComponent(1, 0, 0));
+	ASSERT_TRUE(testWorld.Get<PositionComponent>(entity)->val == PositionComponent(0, 0, 1).val);
+	ASSERT_TRUE(testWorld.Get<VelocityComponent>(entity)->val == VelocityComponent(1, 0, 0).val);
+	ASSERT_ANY_THROW(
+		testWorld.Add(entity, PositionComponent(0, 0, 1));
+	);
+
+	testWorld.Remove<PositionComponent>(entity);
+	ASSERT_FALSE(testWorld.Has<PositionComponent>(entity));
+	ASSERT_TRUE(testWorld.Get<VelocityComponent>(entity)->val == VelocityComponent(1, 0, 0).val);
+	testWorld.Destroy(entity);
+	ASSERT_FALSE(testWorld.CheckEntityAlive(entity));
+	ASSERT_TRUE(testWorld.EntityCount() == 0);
+}
+
+TEST(ArchetypeTest, EachTest) {
+	ArchetypeWorld testWorld;
+	std::vector<EntityID> entities;
+	for (int i = 0; i < 5000; i++)
+	{
+		auto entity = testWorld.Create();
+		testWorld.Add(entity, PositionComponent(i, 0, 0));
+		if (i % 2 == 0)
+			testWorld.Add(entity, VelocityComponent(1, 0, 0));
+		entities.push_back(entity);
+	}
+	for (int i = 0; i < 5000; i += 4)
+	{
+		testWorld.Destroy(entities[i]);
+	}
+	int count = 0;
+	testWorld.Each<PositionComponent, VelocityComponent>([&](EntityID entity, PositionComponent* pPos, VelocityComponent* pVel) {
+		ASSERT_TRUE(testWorld.Get<PositionComponent>(entity) == pPos);
+		pPos->val.x += pVel->val.x;
+		count++;
+	});
+	ASSERT_TRUE(count == 1250);
+	for (int i = 1; i < 5000; i++)
+	{
+		if (i % 4 == 0)
+			continue;
+		ASSERT_TRUE(testWorld.Get<PositionComponent>(entities[i])->val.x == i + (i % 2 == 0 ? 1 : 0));
+	}
+	ASSERT_TRUE(testWorld.ArchetypeCount() == 3);
+}
+
+TEST(ArchetypeTest, ComponentLifetimeTest) {
+	auto counter = std::make_shared<int>(0);
+	{
+		ArchetypeWorld testWorld;
+		for (int i = 0; i < 100; i++)
+		{
+			auto entity = testWorld.Create();
+			testWorld.Add(entity, counter);
+			testWorld.Add(entity, PositionComponent(0, 0, 0));
+			if (i % 2 == 0)
+				testWorld.Destroy(entity);
+		}
+		ASSERT_TRUE(counter.use_count() == 51);
+	}
+	ASSERT_TRUE(counter.use_count() == 1);
+}
+
+struct alignas(64) WideComponent {
+	float lanes[16];
+};
+
+TEST(ArchetypeTest, AlignmentTest) {
+	ArchetypeWorld testWorld;
+	for (int i = 0; i < 1000; i++)
+	{
+		auto entity = testWorld.Create();
+		testWorld.Add(entity, PositionComponent(0, 0, 0));
+		testWorld.Add(entity, WideComponent());
+		ASSERT_TRUE(reinterpret_cast<uintptr_t>(testWorld.Get<WideComponent>(entity)) % alignof(WideComponent) == 0);
+	}
+}
+
+struct HugeComponent {
+	char data[Archetype::ChunkSize];
+};
+
+struct ThrowingMoveComponent {
+	bool throwOnMove = false;
+	ThrowingMoveComponent() = default;
+	ThrowingMoveComponent(const ThrowingMoveComponent& copy) = default;
+	ThrowingMoveComponent(ThrowingMoveComponent&& moved) : throwOnMove(moved.throwOnMove) {
+		if (throwOnMove)
+			throw std::runtime_error("move failed");
+	}
+};
+
+TEST(ArchetypeTest, FailedAddTest) {
+	ArchetypeWorld testWorld;
+	auto entity = testWorld.Create();
+	testWorld.Add(entity, PositionComponent(1, 0, 0));
+	//a row that doesn't fit in a chunk is rejected.
+	ASSERT_ANY_THROW(testWorld.Add(entity, HugeComponent()));
+	ThrowingMoveComponent throwing;
+	throwing.throwOnMove = true;
+	ASSERT_ANY_THROW(testWorld.Add(entity, throwing));
+	//the entity is untouched.
+	ASSERT_FALSE(testWorld.Has<HugeComponent>(entity));
+	ASSERT_FALSE(testWorld.Has<ThrowingMoveComponent>(entity));
+	ASSERT_TRUE(testWorld.Get<PositionComponent>(entity)->val.x == 1);
+	int count = 0;
+	testWorld.Each<PositionComponent>([&](EntityID each, PositionComponent* pPos) {
+		ASSERT_TRUE(each == entity);
+		count++;
+	});
+	ASSERT_TRUE(count == 1);
+	testWorld.Add(entity, ThrowingMoveComponent());
+	ASSERT_TRUE(testWorld.Has<ThrowingMoveComponent>(entity));
+}
+
+TEST(ArchetypeTest, MultipleWorldsTest) {
+	ArchetypeWorld worldA, worldB;
+	//type IDs are shared with World, indices are dense per ArchetypeWorld.
+	ASSERT_EQ(worldA.ConvertComponentTypeToIndex<PositionComponent>(), 0);
+	ASSERT_EQ(worldA.ConvertComponentTypeToIndex<VelocityComponent>(), 1);
+	ASSERT_EQ(worldB.ConvertComponentTypeToIndex<VelocityComponent>(), 0);
+	ASSERT_EQ(worldB.ConvertComponentTypeToIndex<PositionComponent>(), 1);
+	auto entity = worldB.Create();
+	worldB.Add(entity, PositionComponent(1, 0, 0));
+	ASSERT_TRUE(worldB.Get<PositionComponent>(entity)->val.x == 1);
+	ASSERT_FALSE(worldB.Has<VelocityComponent>(entity));
+}
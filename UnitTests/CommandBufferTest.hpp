@@ -0,0 +1,136 @@
+#pragma once
+#include <gtest\gtest.h>
+#include "Resecs\Resecs.h"
+#include "EntityTest.hpp"
+
+using namespace Resecs;
+
+TEST(CommandBufferTest, PlaybackTest) {
+	World testWorld;
+	for (int i = 0; i < 10; i++)
+	{
+		auto entity = testWorld.Create();
+		entity.Add(PositionComponent(i, 0, 0));
+	}
+	auto group = Group::CreateGroup<PositionComponent>(&testWorld);
+	CommandBuffer buffer(&testWorld);
+	for (auto entity : group) {
+		auto x = entity.Get<PositionComponent>()->val.x;
+		if (x < 5) {
+			buffer.Destroy(entity.entityID);
+		}
+		else {
+			buffer.Add(entity.entityID, VelocityComponent(1, 0, 0));
+			buffer.Replace(entity.entityID, PositionComponent(x, 1, 0));
+		}
+	}
+	auto created = buffer.Create();
+	buffer.Add(created, FlagComponent());
+	ASSERT_FALSE(buffer.Empty());
+	ASSERT_TRUE(testWorld.EntityCount() == 11);
+
+	buffer.Playback();
+	ASSERT_TRUE(buffer.Empty());
+	ASSERT_TRUE(testWorld.EntityCount() == 7);
+	ASSERT_TRUE(group.Count() == 5);
+	int count = 0;
+	testWorld.Each<PositionComponent, VelocityComponent>([&](Entity entity, PositionComponent* pPos, VelocityComponent* pVel) {
+		ASSERT_TRUE(pPos->val.y == 1);
+		count++;
+	});
+	ASSERT_TRUE(count == 5);
+	count = 0;
+	testWorld.Each<FlagComponent>([&](Entity entity, FlagComponent* pFlag) {
+		count++;
+	});
+	ASSERT_TRUE(count == 1);
+}
+
+TEST(CommandBufferTest, SkipDeadEntityTest) {
+	World testWorld;
+	auto entity = testWorld.Create();
+	CommandBuffer buffer(&testWorld);
+	buffer.Add(entity.entityID, PositionComponent(0, 0, 0));
+	entity.Destroy();
+	buffer.Playback();
+	ASSERT_TRUE(testWorld.EntityCount() == 1);
+}
+
+TEST(CommandBufferTest, BatchedEventsTest) {
+	World testWorld;
+	auto entities = testWorld.CreateMany(100, PositionComponent(0, 0, 0));
+	std::vector<size_t> batches;
+	auto connection = testWorld.OnComponentChangedOf(testWorld.ConvertComponentTypeToIndex<VelocityComponent>()).Connect([&](const ComponentEventArgs* args, size_t count) {
+		batches.push_back(count);
+	});
+	auto group = Group::CreateGroup<PositionComponent, VelocityComponent>(&testWorld);
+	CommandBuffer buffer(&testWorld);
+	for (auto& entity : entities) {
+		buffer.Add(entity.entityID, VelocityComponent(1, 0, 0));
+	}
+	buffer.Playback();
+	//one batch for all adds.
+	ASSERT_TRUE(batches.size() == 1 && batches[0] == 100);
+	ASSERT_TRUE(group.Count() == 100);
+
+	batches.clear();
+	for (int i = 0; i < 50; i++)
+	{
+		buffer.Remove<VelocityComponent>(entities[i].entityID);
+	}
+	buffer.Replace(entities[0].entityID, VelocityComponent(2, 0, 0));
+	buffer.Replace(entities[99].entityID, VelocityComponent(2, 0, 0));
+	buffer.Playback();
+	//removes, then the replaces: an Added and an Updated.
+	ASSERT_TRUE(batches.size() == 2 && batches[0] == 50 && batches[1] == 2);
+	ASSERT_TRUE(group.Count() == 51);
+	ASSERT_TRUE(entities[0].Get<VelocityComponent>()->val.x == 2);
+	ASSERT_TRUE(entities[99].Get<VelocityComponent>()->val.x == 2);
+	ASSERT_TRUE(entities[1].Get<VelocityComponent>() == nullptr);
+}
+
+TEST(CommandBufferTest, ThrowingPlaybackTest) {
+	World testWorld;
+	auto entity = testWorld.Create();
+	entity.Add(PositionComponent(0, 0, 0));
+	auto group = Group::CreateGroup<VelocityComponent>(&testWorld);
+	CommandBuffer buffer(&testWorld);
+	auto created = buffer.Create();
+	buffer.Add(created, PositionComponent(1, 0, 0));
+	buffer.Add(entity.entityID, VelocityComponent(1, 0, 0));
+	//the entity has a VelocityComponent by then.
+	buffer.Add(entity.entityID, VelocityComponent(2, 0, 0));
+	buffer.Destroy(entity.entityID);
+	ASSERT_ANY_THROW(buffer.Playback());
+	//the rest of the buffer is dropped, nothing is played back twice.
+	ASSERT_TRUE(buffer.Empty());
+	buffer.Playback();
+	ASSERT_TRUE(testWorld.EntityCount() == 3);
+	ASSERT_TRUE(entity.IsAlive());
+	//commands applied before the throw got their events.
+	ASSERT_TRUE(group.Count() == 1);
+	ASSERT_TRUE(entity.Get<VelocityComponent>()->val.x == 1);
+}
+
+TEST(CommandBufferTest, ThreadCommandBuffersTest) {
+	World testWorld;
+	ThreadPool pool(4);
+	testWorld.SetThreadPool(&pool);
+	for (int i = 0; i < 1000; i++)
+	{
+		auto entity = testWorld.Create();
+		entity.Add(PositionComponent(i, 0, 0));
+	}
+	ThreadCommandBuffers buffers(&testWorld);
+	testWorld.ParallelEach<PositionComponent>([&](Entity entity, PositionComponent* pPos) {
+		auto& buffer = buffers.Local();
+		if (int(pPos->val.x) % 2 == 0)
+			buffer.Remove<PositionComponent>(entity.entityID);
+		else
+			buffer.Add(buffer.Create(), VelocityComponent(0, 0, 0));
+	}, 16);
+	buffers.Playback();
+	ASSERT_TRUE(testWorld.View<PositionComponent>().SizeHint() == 500);
+	ASSERT_TRUE(testWorld.View<VelocityComponent>().SizeHint() == 500);
+	ASSERT_TRUE(testWorld.EntityCount() == 1501);
+}
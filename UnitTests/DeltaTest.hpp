@@ -0,0 +1,93 @@
+#pragma once
+#include <gtest\gtest.h>
+#include "Resecs\Resecs.h"
+#include "EntityTest.hpp"
+
+using namespace Resecs;
+
+TEST(DeltaTest, ReplicationTest) {
+	using Replication = DeltaRecorder<PositionComponent, VelocityComponent>;
+	World source, mirror;
+	Replication recorder(&source);
+	Delta delta;
+	std::vector<char> bytes;
+	auto sync = [&]() {
+		recorder.Flush(delta);
+		bytes.clear();
+		delta.Encode(bytes);
+		Delta received;
+		received.Decode(bytes.data(), bytes.size());
+		Replication::Apply(mirror, received);
+	};
+
+	auto entities = source.CreateMany(10, PositionComponent(1, 2, 3));
+	entities[0].Add(VelocityComponent(1, 0, 0));
+	sync();
+	ASSERT_TRUE(mirror.EntityCount() == source.EntityCount());
+	ASSERT_TRUE(mirror.GetEntityHandle(entities[9].entityID).Get<PositionComponent>()->val.z == 3);
+	ASSERT_TRUE(mirror.GetEntityHandle(entities[0].entityID).Has<VelocityComponent>());
+
+	//nothing changed, nothing sent.
+	recorder.Flush(delta);
+	ASSERT_TRUE(delta.Empty());
+
+	//a write is sent as the new bytes of that component only.
+	entities[3].GetMut<PositionComponent>()->val.x = 7;
+	entities[3].GetMut<PositionComponent>()->val.y = 8;
+	entities[0].Remove<VelocityComponent>();
+	entities[1].Destroy();
+	entities[2].Add(VelocityComponent(0, 0, 5));
+	entities[2].Remove<VelocityComponent>();
+	auto reused = source.Create();	//takes the slot of entities[1].
+	reused.Add(VelocityComponent(4, 4, 4));
+	recorder.Flush(delta);
+	ASSERT_TRUE(delta.entities.size() == 2);
+	//the reused slot also gets a Removed of the PositionComponent that died with entities[1], which the mirror skips.
+	ASSERT_TRUE(delta.components.size() == 5);
+	ASSERT_TRUE(delta.values.size() == sizeof(PositionComponent) + sizeof(VelocityComponent));
+	Replication::Apply(mirror, delta);
+
+	auto mirrored = mirror.GetEntityHandle(entities[3].entityID).Get<PositionComponent>()->val;
+	ASSERT_TRUE(mirrored.x == 7 && mirrored.y == 8);
+	ASSERT_FALSE(mirror.GetEntityHandle(entities[0].entityID).Has<VelocityComponent>());
+	ASSERT_FALSE(mirror.CheckEntityAlive(entities[1].entityID));
+	ASSERT_FALSE(mirror.GetEntityHandle(entities[2].entityID).Has<VelocityComponent>());
+	ASSERT_TRUE(mirror.GetEntityHandle(reused.entityID).Get<VelocityComponent>()->val.x == 4);
+
+	//a mirror that missed a delta is detected.
+	source.Create();
+	recorder.Flush(delta);
+	source.Create();
+	ASSERT_ANY_THROW(sync());
+	ASSERT_ANY_THROW(Replication recorder2(&source));	//types already recorded.
+}
+
+TEST(DeltaTest, ParallelWritesTest) {
+	using Replication = DeltaRecorder<PositionComponent>;
+	World source, mirror;
+	ThreadPool pool(4);
+	source.SetThreadPool(&pool);
+	Replication recorder(&source);
+	Delta delta;
+	auto entities = source.CreateMany(10000, PositionComponent(0, 0, 0));
+	recorder.Flush(delta);
+	Replication::Apply(mirror, delta);
+
+	//Mut<T> in ParallelEach records the written entities like a single-threaded Each.
+	for (int frame = 1; frame <= 3; frame++)
+	{
+		source.ParallelEach<Mut<PositionComponent>>([=](Entity entity, PositionComponent* pPos) {
+			if (entity.entityID.index % 2 == 0)
+				pPos->val.x = frame;
+		}, 64);
+		recorder.Flush(delta);
+		ASSERT_TRUE(delta.components.size() == 10000);
+		Replication::Apply(mirror, delta);
+	}
+	for (auto& entity : entities) {
+		auto expected = entity.entityID.index % 2 == 0 ? 3 : 0;
+		ASSERT_TRUE(mirror.GetEntityHandle(entity.entityID).Get<PositionComponent>()->val.x == expected);
+	}
+	recorder.Flush(delta);
+	ASSERT_TRUE(delta.Empty());
+}
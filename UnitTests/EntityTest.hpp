@@ -110,3 +110,198 @@ TEST(ComponentTest, GetComponentTest) {
 	ptrAdd->val.x = 1;
 	ASSERT_TRUE(entity.Get<PositionComponent>()->val == PositionComponent(1, 0, 5).val);
 }
+
+TEST(ComponentTest, RemoveKeepsOtherComponentsTest) {
+	World testWorld;
+	std::vector<Entity> entities;
+	for (int i = 0; i < 10; i++)
+	{
+		auto entity = testWorld.Create();
+		entity.Add(PositionComponent(i, 0, 0));
+		entities.push_back(entity);
+	}
+	entities[0].Remove<PositionComponent>();
+	entities[5].Destroy();
+	for (int i = 1; i < 10; i++)
+	{
+		if (i == 5)
+			continue;
+		ASSERT_TRUE(entities[i].Get<PositionComponent>()->val == PositionComponent(i, 0, 0).val);
+	}
+	ASSERT_TRUE(entities[0].Get<PositionComponent>() == nullptr);
+}
+
+TEST(ComponentTest, ComponentChangedOfTest) {
+	World testWorld;
+	auto entity = testWorld.Create();
+	entity.Add(PositionComponent(0, 0, 1));
+	int calls = 0;
+	size_t events = 0;
+	auto connection = testWorld.OnComponentChangedOf<VelocityComponent>().Connect(
+		[&](const ComponentEventArgs* args, size_t count) {
+		calls++;
+		events += count;
+		ASSERT_TRUE(args[0].componentTypeIndex == testWorld.ConvertComponentTypeToIndex<VelocityComponent>());
+	}
+	);
+	//other types are not routed to the listener.
+	entity.Remove<PositionComponent>();
+	entity.Add(PositionComponent(0, 0, 1));
+	ASSERT_EQ(calls, 0);
+
+	entity.Add(VelocityComponent(0, 0, 1));
+	ASSERT_EQ(calls, 1);
+	entity.Destroy();
+	ASSERT_EQ(calls, 2);
+	ASSERT_EQ(events, 2u);
+}
+
+TEST(ComponentTest, CreateManyTest) {
+	World testWorld;
+	auto group = Group::CreateGroup<PositionComponent, VelocityComponent>(&testWorld);
+	int calls = 0;
+	size_t lastCount = 0;
+	auto connection = testWorld.OnComponentChangedOf<PositionComponent>().Connect(
+		[&](const ComponentEventArgs* args, size_t count) {
+		calls++;
+		lastCount = count;
+	}
+	);
+	//reuse some slots.
+	testWorld.Create().Destroy();
+	auto entities = testWorld.CreateMany(100, PositionComponent(1, 2, 3), VelocityComponent(4, 5, 6));
+	ASSERT_EQ(entities.size(), 100u);
+	ASSERT_EQ(calls, 1);
+	ASSERT_EQ(lastCount, 100u);
+	ASSERT_EQ(group.Count(), 100u);
+	ASSERT_EQ(testWorld.EntityCount(), 101);
+	for (auto& entity : entities) {
+		ASSERT_TRUE(entity.Get<PositionComponent>()->val == PositionComponent(1, 2, 3).val);
+		ASSERT_TRUE(entity.Get<VelocityComponent>()->val == VelocityComponent(4, 5, 6).val);
+	}
+	entities[10].Destroy();
+	ASSERT_EQ(group.Count(), 99u);
+	ASSERT_TRUE(entities[11].Get<PositionComponent>()->val == PositionComponent(1, 2, 3).val);
+
+	//dead slots are reused before new ones, creation is announced once.
+	std::vector<EntityID> created;
+	int createdCalls = 0;
+	auto createdConnection = testWorld.OnEntitiesCreated.Connect([&](const EntityID* ids, size_t count) {
+		created.insert(created.end(), ids, ids + count);
+		createdCalls++;
+	});
+	int singleCalls = 0;
+	auto singleConnection = testWorld.OnEntityCreated.Connect([&](EntityID id) {
+		ASSERT_TRUE(testWorld.CheckEntityAlive(id));
+		singleCalls++;
+	});
+	entities[20].Destroy();
+	auto more = testWorld.CreateMany(50, PositionComponent(0, 0, 0));
+	ASSERT_EQ(createdCalls, 1);
+	ASSERT_EQ(singleCalls, 50);
+	ASSERT_EQ(created.size(), 50u);
+	ASSERT_EQ(testWorld.EntityCount(), 149);
+	ASSERT_EQ(more[0].entityID.index, entities[20].entityID.index);
+	ASSERT_EQ(more[1].entityID.index, entities[10].entityID.index);
+	ASSERT_EQ(more[1].entityID.generation, entities[10].entityID.generation + 1);
+	for (size_t i = 0; i < more.size(); i++)
+	{
+		ASSERT_TRUE(created[i] == more[i].entityID);
+		ASSERT_FALSE(more[i].Has<VelocityComponent>());
+	}
+	ASSERT_EQ(group.Count(), 98u);
+}
+
+TEST(ComponentTest, MultipleWorldsTest) {
+	World worldA, worldB;
+	//types are registered in different orders, each World keeps its own dense indices.
+	ASSERT_EQ(worldA.ConvertComponentTypeToIndex<PositionComponent>(), 0);
+	ASSERT_EQ(worldA.ConvertComponentTypeToIndex<VelocityComponent>(), 1);
+	ASSERT_EQ(worldB.ConvertComponentTypeToIndex<VelocityComponent>(), 0);
+	ASSERT_EQ(worldB.ConvertComponentTypeToIndex<PositionComponent>(), 1);
+
+	auto entityA = worldA.Create();
+	auto entityB = worldB.Create();
+	entityA.Add(PositionComponent(1, 0, 0));
+	entityB.Add(PositionComponent(2, 0, 0));
+	ASSERT_TRUE(entityA.Get<PositionComponent>()->val == PositionComponent(1, 0, 0).val);
+	ASSERT_TRUE(entityB.Get<PositionComponent>()->val == PositionComponent(2, 0, 0).val);
+	ASSERT_FALSE(entityB.Has<VelocityComponent>());
+}
+
+/* Holds a buffer and counts its copies. */
+struct BufferComponent {
+	static int copies;
+	std::vector<int> data;
+	BufferComponent() = default;
+	explicit BufferComponent(std::vector<int> data) : data(std::move(data)) {}
+	BufferComponent(const BufferComponent& copy) : data(copy.data) {
+		copies++;
+	}
+	BufferComponent(BufferComponent&& toMove) = default;
+	BufferComponent& operator=(const BufferComponent& copy) {
+		data = copy.data;
+		copies++;
+		return *this;
+	}
+	BufferComponent& operator=(BufferComponent&& toMove) = default;
+};
+int BufferComponent::copies = 0;
+
+struct AggregateComponent {
+	int a;
+	float b;
+};
+
+TEST(ComponentTest, EmplacePatchTest) {
+	World testWorld;
+	std::vector<ComponentEventArgs> events;
+	auto connection = testWorld.OnComponentChanged.Connect([&](ComponentEventArgs arg) {
+		events.push_back(arg);
+	});
+	auto group = Group::CreateGroup<BufferComponent>(&testWorld);
+	int left = 0;
+	auto leftConnection = group.OnEntityLeft.Connect([&](EntityID entity) {
+		left++;
+	});
+	BufferComponent::copies = 0;
+	std::vector<Entity> entities;
+	for (int i = 0; i < 100; i++)
+	{
+		entities.push_back(testWorld.Create());
+		entities.back().Emplace<BufferComponent>(std::vector<int>(1000, i));
+	}
+	ASSERT_ANY_THROW(entities[0].Add(BufferComponent(std::vector<int>(10, 0))));
+	ASSERT_ANY_THROW(entities[0].Emplace<BufferComponent>());
+	ASSERT_TRUE(events.size() == 100);
+	ASSERT_TRUE(entities[99].Get<BufferComponent>()->data.size() == 1000);
+
+	//Patch edits in place and fires one Updated event, the group keeps the entity.
+	events.clear();
+	auto since = testWorld.IncrementChangeTick();
+	entities[5].Patch<BufferComponent>([](BufferComponent& buffer) {
+		buffer.data.push_back(-1);
+	});
+	ASSERT_TRUE(events.size() == 1);
+	ASSERT_TRUE(events[0].type == ComponentEventType::Updated);
+	ASSERT_TRUE(events[0].entity == entities[5].entityID);
+	ASSERT_TRUE(entities[5].Get<BufferComponent>()->data.size() == 1001);
+	int changed = 0;
+	testWorld.Each<Changed<BufferComponent>>([&](Entity entity, BufferComponent* pBuffer) { changed++; }, since);
+	ASSERT_TRUE(changed == 1);
+
+	//Replace of an existing component is a move and an Updated event too.
+	events.clear();
+	entities[6].Replace(BufferComponent(std::vector<int>(3, 6)));
+	ASSERT_TRUE(events.size() == 1);
+	ASSERT_TRUE(events[0].type == ComponentEventType::Updated);
+	ASSERT_TRUE(entities[6].Get<BufferComponent>()->data.size() == 3);
+	ASSERT_TRUE(group.Count() == 100);
+	ASSERT_TRUE(left == 0);
+	ASSERT_TRUE(BufferComponent::copies == 0);
+
+	auto entity = testWorld.Create();
+	ASSERT_ANY_THROW(entity.Patch<BufferComponent>([](BufferComponent& buffer) {}));
+	entity.Emplace<AggregateComponent>(1, 2.0f);
+	ASSERT_TRUE(entity.Get<AggregateComponent>()->a == 1 && entity.Get<AggregateComponent>()->b == 2.0f);
+}
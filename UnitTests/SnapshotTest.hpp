@@ -0,0 +1,97 @@
+#pragma once
+#include <gtest\gtest.h>
+#include <cstdio>
+#include "Resecs\Resecs.h"
+#include "EntityTest.hpp"
+
+using namespace Resecs;
+
+TEST(SnapshotTest, SaveLoadTest) {
+	const char* path = "snapshot_test.bin";
+	World source;
+	auto entities = source.CreateMany(100, PositionComponent(1, 2, 3));
+	for (int i = 0; i < 100; i += 3)
+	{
+		entities[i].Add(VelocityComponent(i, 0, 0));
+	}
+	entities[10].Destroy();
+	entities[20].Destroy();
+	auto since = source.IncrementChangeTick();
+	entities[5].GetMut<PositionComponent>()->val.x = 42;
+	Snapshot::Save<PositionComponent, VelocityComponent>(source, path);
+
+	World loaded;
+	//registered in another order, signatures get remapped.
+	loaded.ConvertComponentTypeToIndex<VelocityComponent>();
+	auto group = Group::CreateGroup<PositionComponent, VelocityComponent>(&loaded);
+	Snapshot::Load<PositionComponent, VelocityComponent>(loaded, path);
+	std::remove(path);
+
+	ASSERT_TRUE(loaded.EntityCount() == source.EntityCount());
+	ASSERT_FALSE(loaded.CheckEntityAlive(entities[10].entityID));
+	ASSERT_TRUE(loaded.CheckEntityAlive(entities[99].entityID));
+	auto entity = loaded.GetEntityHandle(entities[5].entityID);
+	ASSERT_TRUE(entity.Get<PositionComponent>()->val.x == 42);
+	ASSERT_FALSE(entity.Has<VelocityComponent>());
+	ASSERT_TRUE(loaded.GetEntityHandle(entities[6].entityID).Get<VelocityComponent>()->val.x == 6);
+	//the group created before Load got the Added events.
+	ASSERT_TRUE(group.Count() == 34);
+	//ticks and the change tick are kept.
+	size_t changed = 0;
+	loaded.Each<Changed<PositionComponent>>([&](Entity e, PositionComponent* pPos) { changed++; }, since);
+	ASSERT_TRUE(changed == 1);
+	//the free list is kept, so both worlds reuse the same slots.
+	ASSERT_TRUE(loaded.Create().entityID == source.Create().entityID);
+
+	ASSERT_ANY_THROW(Snapshot::Load<PositionComponent>(loaded, path));	//file is removed, and world is not empty.
+	Snapshot::Save<PositionComponent>(source, path);
+	World wrongTypes;
+	ASSERT_ANY_THROW((Snapshot::Load<VelocityComponent>(wrongTypes, path)));
+	std::remove(path);
+}
+
+TEST(SnapshotTest, CorruptedFileTest) {
+	const char* path = "snapshot_corrupt_test.bin";
+	World source;
+	auto entities = source.CreateMany(10, PositionComponent(1, 2, 3));
+	entities[3].Destroy();
+	entities[7].Destroy();
+	Snapshot::Save<PositionComponent>(source, path);
+	std::vector<char> bytes;
+	{
+		FILE* file = fopen(path, "rb");
+		int c;
+		while ((c = fgetc(file)) != EOF) {
+			bytes.push_back(static_cast<char>(c));
+		}
+		fclose(file);
+	}
+	//the slot table starts at the first ChunkAlignment boundary after the header, signatures at the next one after it.
+	size_t slots = 11;
+	size_t signatureOffset = ChunkAlignment + (slots * sizeof(EntityID) + ChunkAlignment - 1) / ChunkAlignment * ChunkAlignment;
+	auto loadPatched = [&](size_t offset, const void* value, size_t size) {
+		auto patched = bytes;
+		memcpy(patched.data() + offset, value, size);
+		FILE* file = fopen(path, "wb");
+		fwrite(patched.data(), 1, patched.size(), file);
+		fclose(file);
+		World loaded;
+		Snapshot::Load<PositionComponent>(loaded, path);
+	};
+	auto linkOf = [&](Entity entity) {
+		return ChunkAlignment + entity.entityID.index * sizeof(EntityID);
+	};
+	EntityIndex_t outOfRange = 1000;
+	EntityIndex_t alive = entities[7].entityID.index;
+	ComponentActivationBitset empty;
+	ASSERT_NO_THROW(loadPatched(0, bytes.data(), 0));
+	//the free list is 7 -> 3.
+	ASSERT_ANY_THROW(loadPatched(linkOf(entities[3]), &outOfRange, sizeof(outOfRange)));	//link out of range.
+	ASSERT_ANY_THROW(loadPatched(linkOf(entities[3]), &alive, sizeof(alive)));	//cycle.
+	ASSERT_ANY_THROW(loadPatched(linkOf(entities[5]), &outOfRange, sizeof(outOfRange)));	//dead slot missing from the free list.
+	ASSERT_ANY_THROW(loadPatched(signatureOffset + entities[5].entityID.index * sizeof(empty), &empty, sizeof(empty)));	//pool has an entity without the component.
+	//truncated pool.
+	bytes.resize(bytes.size() - sizeof(PositionComponent));
+	ASSERT_ANY_THROW(loadPatched(0, bytes.data(), 0));
+	std::remove(path);
+}
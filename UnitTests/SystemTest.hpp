@@ -0,0 +1,182 @@
+#pragma once
+#include <gtest\gtest.h>
+#include <mutex>
+#include <thread>
+#include "Resecs\Resecs.h"
+#include "EntityTest.hpp"
+
+using namespace Resecs;
+
+class RecordingSystem : public System {
+public:
+	RecordingSystem(int id, std::vector<int>* log, std::mutex* logMutex) : id(id), log(log), logMutex(logMutex) {}
+	virtual void Update() {
+		std::lock_guard<std::mutex> lock(*logMutex);
+		log->push_back(id);
+	}
+	using System::Reads;
+	using System::Writes;
+	int id;
+	std::vector<int>* log;
+	std::mutex* logMutex;
+};
+
+TEST(SystemTest, ConflictTest) {
+	std::vector<int> log;
+	std::mutex logMutex;
+	RecordingSystem move(0, &log, &logMutex), render(1, &log, &logMutex), ai(2, &log, &logMutex), undeclared(3, &log, &logMutex);
+	move.Reads<VelocityComponent>();
+	move.Writes<PositionComponent>();
+	render.Reads<PositionComponent>();
+	ai.Writes<VelocityComponent, FlagComponent>();
+	ASSERT_TRUE(move.ConflictsWith(render));
+	ASSERT_TRUE(move.ConflictsWith(ai));
+	ASSERT_FALSE(render.ConflictsWith(ai));
+	ASSERT_TRUE(undeclared.ConflictsWith(render));
+}
+
+TEST(SystemTest, ParallelFeatureOrderTest) {
+	std::vector<int> log;
+	std::mutex logMutex;
+	ThreadPool pool(4);
+	ParallelFeature feature(&pool);
+	auto writer = std::make_shared<RecordingSystem>(0, &log, &logMutex);
+	writer->Writes<PositionComponent>();
+	auto reader1 = std::make_shared<RecordingSystem>(1, &log, &logMutex);
+	reader1->Reads<PositionComponent>();
+	auto reader2 = std::make_shared<RecordingSystem>(2, &log, &logMutex);
+	reader2->Reads<PositionComponent, VelocityComponent>();
+	auto barrier = std::make_shared<RecordingSystem>(3, &log, &logMutex);
+	auto last = std::make_shared<RecordingSystem>(4, &log, &logMutex);
+	last->Reads<VelocityComponent>();
+	feature.systems = { writer, reader1, reader2, barrier, last };
+	feature.Start();
+	for (int frame = 0; frame < 100; frame++)
+	{
+		log.clear();
+		feature.Update();
+		ASSERT_TRUE(log.size() == 5);
+		ASSERT_TRUE(log[0] == 0);
+		ASSERT_TRUE(log[3] == 3);
+		ASSERT_TRUE(log[4] == 4);
+	}
+}
+
+template<int N>
+struct LateComponent {};
+
+class LateSystemBase : public System {
+public:
+	LateSystemBase(World* world) : world(world) {}
+	World* world;
+	int frame = 0;
+	int index = -1;
+	int count = 0;
+};
+
+/* Uses a component type and a query of its own only from its fourth frame on. */
+template<int N>
+class LateSystem : public LateSystemBase {
+public:
+	LateSystem(World* world) : LateSystemBase(world) {
+		Reads<PositionComponent, LateComponent<N>>();
+	}
+	virtual void Update() {
+		if (++frame < 4)
+			return;
+		index = world->ConvertComponentTypeToIndex<LateComponent<N>>();
+		count = 0;
+		world->View<PositionComponent, Without<LateComponent<N>>>().Each([&](Entity entity, PositionComponent*) { count++; });
+	}
+};
+
+template<int... Ns>
+std::vector<std::shared_ptr<System>> CreateLateSystems(World* world, std::integer_sequence<int, Ns...>) {
+	return { std::make_shared<LateSystem<Ns>>(world)... };
+}
+
+TEST(SystemTest, ParallelFeatureLateRegistrationTest) {
+	World world;
+	for (int i = 0; i < 100; i++)
+	{
+		world.Create().Add<PositionComponent>(PositionComponent(1, 2, 3));
+	}
+	ThreadPool pool(4);
+	ParallelFeature feature(&pool);
+	//systems only read, so they all run at the same time, and register their types and queries meanwhile.
+	feature.systems = CreateLateSystems(&world, std::make_integer_sequence<int, 16>());
+	feature.Start();
+	for (int frame = 0; frame < 10; frame++)
+	{
+		feature.Update();
+	}
+	std::vector<bool> taken(MAX_COMPONENT_COUNT, false);
+	taken[world.ConvertComponentTypeToIndex<PositionComponent>()] = true;
+	for (auto& system : feature.systems) {
+		auto late = static_cast<LateSystemBase*>(system.get());
+		ASSERT_TRUE(late->count == 100);
+		//every type got its own index.
+		ASSERT_TRUE(late->index >= 0 && !taken[late->index]);
+		taken[late->index] = true;
+	}
+}
+
+class ThrowingSystem : public System {
+public:
+	virtual void Update() {
+		throw std::runtime_error("failed");
+	}
+	using System::Reads;
+};
+
+TEST(SystemTest, ParallelFeatureThrowTest) {
+	std::vector<int> log;
+	std::mutex logMutex;
+	ThreadPool pool(4);
+	ParallelFeature feature(&pool);
+	auto thrower = std::make_shared<ThrowingSystem>();
+	thrower->Reads<PositionComponent>();
+	auto reader = std::make_shared<RecordingSystem>(0, &log, &logMutex);
+	reader->Reads<PositionComponent>();
+	auto barrier = std::make_shared<RecordingSystem>(1, &log, &logMutex);
+	feature.systems = { thrower, reader, barrier };
+	feature.Start();
+	//the first frame runs sequentially, the others on the pool. Every system still runs.
+	for (int frame = 0; frame < 10; frame++)
+	{
+		log.clear();
+		ASSERT_THROW(feature.Update(), std::runtime_error);
+		ASSERT_TRUE(log.size() == 2);
+		ASSERT_TRUE(log[1] == 1);
+	}
+}
+
+TEST(SystemTest, ProfilerTest) {
+	Profiler profiler(4);
+	for (int i = 0; i < 6; i++)
+	{
+		profiler.Record("sample" + std::to_string(i), i * 10, 5);
+	}
+	//only the latest 4 samples are kept, oldest first.
+	auto samples = profiler.Samples();
+	ASSERT_TRUE(samples.size() == 4);
+	ASSERT_TRUE(samples[0].name == "sample2");
+	ASSERT_TRUE(samples[3].name == "sample5");
+	ASSERT_TRUE(samples[3].start == 50);
+	profiler.Clear();
+	ASSERT_TRUE(profiler.Samples().empty());
+
+#ifdef RESECS_PROFILING
+	std::vector<int> log;
+	std::mutex logMutex;
+	Feature feature;
+	auto system = std::make_shared<RecordingSystem>(0, &log, &logMutex);
+	system->SetName("Recording");
+	feature.systems = { system };
+	Profiler::Default().Clear();
+	feature.Update();
+	auto recorded = Profiler::Default().Samples();
+	ASSERT_TRUE(recorded.size() == 1);
+	ASSERT_TRUE(recorded[0].name == "Recording");
+#endif
+}
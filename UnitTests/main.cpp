@@ -3,6 +3,11 @@
 #include "Resecs\Resecs.h"
 
 #include "EntityTest.hpp"
+#include "ArchetypeTest.hpp"
+#include "SystemTest.hpp"
+#include "CommandBufferTest.hpp"
+#include "SnapshotTest.hpp"
+#include "DeltaTest.hpp"
 
 using namespace Resecs;
 
@@ -18,15 +23,21 @@ TEST(WorldTest, EntityCreationTest) {
 	ASSERT_TRUE(testWorld.EntityCount() == 3);
 	entity.Destroy();
 	entity2.Destroy();
-	for (size_t i = 0; i < World::MAX_ENTITY_COUNT - 1; i++)
-	{
-		auto tempEntity = testWorld.Create();
-	}
-	ASSERT_TRUE(testWorld.EntityCount() == World::MAX_ENTITY_COUNT);
-
 	ASSERT_ANY_THROW(
-		auto tempEntity = testWorld.Create();	//should cause a overflow.
+		entity.Destroy();	//already destroyed.
 	);
+
+	//slots of destroyed entities are reused, with a new generation.
+	auto entity3 = testWorld.Create();
+	ASSERT_TRUE(entity3.entityID.index == entity2.entityID.index);
+	ASSERT_FALSE(entity3.entityID == entity2.entityID);
+	ASSERT_FALSE(entity2.IsAlive());
+
+	//no max entity count, the slot table used to be capped at 2 << 20.
+	const int count = (2 << 20) + 1;
+	testWorld.CreateMany(count);
+	ASSERT_TRUE(testWorld.EntityCount() == count + 2);
+	ASSERT_TRUE(testWorld.Create().entityID.index == count + 2);
 }
 
 TEST(WorldTest, EntityDestroyTest) {
@@ -89,6 +100,276 @@ TEST(WorldTest, ComponentEventTest) {
 	);
 }
 
+TEST(WorldTest, EachTest) {
+	World testWorld;
+	for (int i = 0; i < 100; i++)
+	{
+		auto entity = testWorld.Create();
+		entity.Add(PositionComponent(0, 0, 0));
+		if (i % 2 == 0)
+			entity.Add(VelocityComponent(1, 0, 0));
+		if (i % 3 == 0)
+			entity.Destroy();
+	}
+	int count = 0;
+	testWorld.Each<PositionComponent, VelocityComponent>([&](Entity entity, PositionComponent* pPos, VelocityComponent* pVel) {
+		ASSERT_TRUE(entity.Get<PositionComponent>() == pPos);
+		pPos->val.x += pVel->val.x;
+		count++;
+	});
+	ASSERT_TRUE(count == 33);
+
+	//destroying the current entity during iteration is allowed.
+	testWorld.Each<PositionComponent>([&](Entity entity, PositionComponent* pPos) {
+		if (pPos->val.x == 1)
+			entity.Destroy();
+	});
+	count = 0;
+	testWorld.Each<PositionComponent>([&](Entity entity, PositionComponent* pPos) {
+		ASSERT_TRUE(pPos->val.x == 0);
+		count++;
+	});
+	ASSERT_TRUE(count == 33);
+}
+
+TEST(WorldTest, ViewTest) {
+	World testWorld;
+	std::vector<Entity> entities;
+	for (int i = 0; i < 100; i++)
+	{
+		auto entity = testWorld.Create();
+		entity.Add(PositionComponent(i, 0, 0));
+		if (i % 10 == 0)
+			entity.Add(VelocityComponent(1, 0, 0));
+		entities.push_back(entity);
+	}
+	auto view = testWorld.View<PositionComponent, VelocityComponent>();
+	ASSERT_TRUE(view.SizeHint() == 10);
+	int count = 0;
+	for (auto [entity, pPos, pVel] : view) {
+		ASSERT_TRUE(entity.Get<PositionComponent>() == pPos);
+		ASSERT_TRUE(entity.Get<VelocityComponent>() == pVel);
+		pPos->val.x += pVel->val.x;
+		count++;
+	}
+	ASSERT_TRUE(count == 10);
+	ASSERT_TRUE(entities[10].Get<PositionComponent>()->val.x == 11);
+
+	count = 0;
+	view.Each([&](Entity entity, PositionComponent* pPos, VelocityComponent* pVel) {
+		entity.Remove<VelocityComponent>();
+		count++;
+	});
+	ASSERT_TRUE(count == 10);
+	ASSERT_TRUE(view.begin() == view.end());
+}
+
+TEST(WorldTest, ViewStructuralChangeTest) {
+	World testWorld;
+	auto entities = testWorld.CreateMany(10, PositionComponent(0, 0, 0), VelocityComponent(1, 0, 0));
+	//the driving pool grows(and moves) while it's iterated, new members are not visited.
+	int count = 0;
+	testWorld.View<VelocityComponent>().Each([&](Entity entity, VelocityComponent* pVel) {
+		ASSERT_TRUE(pVel->val.x == 1);
+		testWorld.CreateMany(1000, VelocityComponent(2, 0, 0));
+		count++;
+	});
+	ASSERT_TRUE(count == 10);
+	count = 0;
+	for (auto [entity, pPos, pVel] : testWorld.View<PositionComponent, VelocityComponent>()) {
+		ASSERT_TRUE(pPos->val.x == 0);
+		entity.Add(FlagComponent());
+		testWorld.CreateMany(1000, PositionComponent(1, 0, 0), VelocityComponent(2, 0, 0));
+		count++;
+	}
+	ASSERT_TRUE(count == 10);
+	//it shrinks below the current position.
+	count = 0;
+	testWorld.View<FlagComponent>().Each([&](Entity entity, FlagComponent* pFlag) {
+		for (auto& other : entities) {
+			if (other.Has<FlagComponent>())
+				other.Remove<FlagComponent>();
+		}
+		count++;
+	});
+	ASSERT_TRUE(count == 1);
+	count = 0;
+	for (auto [entity, pVel] : testWorld.View<VelocityComponent>()) {
+		if (count++ == 0) {
+			testWorld.Each<VelocityComponent>([](Entity other, VelocityComponent* pOther) {
+				other.Remove<VelocityComponent>();
+			});
+		}
+	}
+	ASSERT_TRUE(count == 1);
+}
+
+TEST(WorldTest, ChangeTickTest) {
+	World testWorld;
+	std::vector<Entity> entities;
+	for (int i = 0; i < 10; i++)
+	{
+		auto entity = testWorld.Create();
+		entity.Add(PositionComponent(i, 0, 0));
+		entity.Add(VelocityComponent(1, 0, 0));
+		entities.push_back(entity);
+	}
+	//first run sees everything.
+	uint32_t lastRun = 0;
+	auto since = lastRun;
+	lastRun = testWorld.IncrementChangeTick();
+	int count = 0;
+	testWorld.Each<Added<PositionComponent>>([&](Entity entity, PositionComponent* pPos) {
+		count++;
+	}, since);
+	ASSERT_EQ(count, 10);
+
+	//nothing happened since.
+	since = lastRun;
+	lastRun = testWorld.IncrementChangeTick();
+	count = 0;
+	testWorld.Each<Changed<PositionComponent>>([&](Entity entity, PositionComponent* pPos) {
+		count++;
+	}, since);
+	ASSERT_EQ(count, 0);
+
+	//Get() doesn't mark the component, GetMut() and Mut<T> do.
+	entities[0].Get<PositionComponent>()->val.x = 100;
+	entities[1].GetMut<PositionComponent>()->val.x = 100;
+	testWorld.View<Mut<PositionComponent>, VelocityComponent>().Each([&](Entity entity, PositionComponent* pPos, VelocityComponent* pVel) {
+		if (entity.entityID == entities[2].entityID)
+			pPos->val.x += pVel->val.x;
+	});
+	auto newEntity = testWorld.Create();
+	newEntity.Add(PositionComponent(0, 0, 0));
+	since = lastRun;
+	lastRun = testWorld.IncrementChangeTick();
+	count = 0;
+	for (auto [entity, pPos] : testWorld.View<Changed<PositionComponent>>(since)) {
+		count++;
+	}
+	ASSERT_EQ(count, 11);
+	count = 0;
+	testWorld.Each<Added<PositionComponent>, VelocityComponent>([&](Entity entity, PositionComponent* pPos, VelocityComponent* pVel) {
+		count++;
+	}, since);
+	ASSERT_EQ(count, 0);
+	count = 0;
+	testWorld.Each<Added<PositionComponent>>([&](Entity entity, PositionComponent* pPos) {
+		ASSERT_TRUE(entity.entityID == newEntity.entityID);
+		count++;
+	}, since);
+	ASSERT_EQ(count, 1);
+
+	//only entities[1] is written after a single GetMut.
+	entities[1].GetMut<PositionComponent>();
+	since = lastRun;
+	lastRun = testWorld.IncrementChangeTick();
+	count = 0;
+	testWorld.Each<Changed<PositionComponent>>([&](Entity entity, PositionComponent* pPos) {
+		ASSERT_TRUE(entity.entityID == entities[1].entityID);
+		count++;
+	}, since);
+	ASSERT_EQ(count, 1);
+}
+
+TEST(WorldTest, ConcurrentChangeTickTest) {
+	World testWorld;
+	ThreadPool pool(4);
+	auto first = testWorld.GetChangeTick();
+	std::vector<uint32_t> ticks(10000);
+	pool.ParallelFor(ticks.size(), 16, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++)
+		{
+			ticks[i] = testWorld.IncrementChangeTick();
+		}
+	});
+	//no tick is lost or handed out twice.
+	std::sort(ticks.begin(), ticks.end());
+	for (size_t i = 0; i < ticks.size(); i++)
+	{
+		ASSERT_EQ(ticks[i], first + i);
+	}
+	ASSERT_EQ(testWorld.GetChangeTick(), first + ticks.size());
+}
+
+TEST(WorldTest, ParallelEachTest) {
+	World testWorld;
+	ThreadPool pool(4);
+	testWorld.SetThreadPool(&pool);
+	for (int i = 0; i < 10000; i++)
+	{
+		auto entity = testWorld.Create();
+		entity.Add(PositionComponent(0, 0, 0));
+		if (i % 2 == 0)
+			entity.Add(VelocityComponent(1, 0, 0));
+	}
+	std::atomic<int> count(0);
+	testWorld.ParallelEach<PositionComponent, VelocityComponent>([&](Entity entity, PositionComponent* pPos, VelocityComponent* pVel) {
+		pPos->val.x += pVel->val.x;
+		count++;
+	}, 64);
+	ASSERT_TRUE(count == 5000);
+	testWorld.Each<PositionComponent>([&](Entity entity, PositionComponent* pPos) {
+		ASSERT_TRUE(pPos->val.x == (entity.Has<VelocityComponent>() ? 1 : 0));
+	});
+}
+
+TEST(WorldTest, ParallelEachThrowTest) {
+	World testWorld;
+	ThreadPool pool(4);
+	testWorld.SetThreadPool(&pool);
+	for (int i = 0; i < 10000; i++)
+	{
+		testWorld.Create().Add(PositionComponent(0, 0, 0));
+	}
+	//the exception comes back to the caller after every range ran, and the pool keeps working.
+	for (int frame = 0; frame < 3; frame++)
+	{
+		std::atomic<int> count(0);
+		ASSERT_THROW(
+			testWorld.ParallelEach<PositionComponent>([&](Entity entity, PositionComponent* pPos) {
+				if (count++ % 1000 == 0)
+					throw std::runtime_error("failed");
+			}, 64),
+			std::runtime_error
+		);
+		ASSERT_TRUE(count > 64);
+	}
+	std::atomic<int> count(0);
+	testWorld.ParallelEach<PositionComponent>([&](Entity entity, PositionComponent* pPos) {
+		count++;
+	}, 64);
+	ASSERT_TRUE(count == 10000);
+}
+
+template<int N>
+struct IndexedComponent {};
+
+template<int... Ns>
+void RegisterIndexedComponents(World& world, std::integer_sequence<int, Ns...>) {
+	int indices[] = { world.ConvertComponentTypeToIndex<IndexedComponent<Ns>>()... };
+	(void)indices;
+}
+
+TEST(WorldTest, ComponentTypeLimitTest) {
+	ASSERT_TRUE(sizeof(ComponentActivationBitset) == MAX_COMPONENT_COUNT / 8);
+	World testWorld;
+	RegisterIndexedComponents(testWorld, std::make_integer_sequence<int, MAX_COMPONENT_COUNT>());
+	ASSERT_ANY_THROW(
+		testWorld.ConvertComponentTypeToIndex<PositionComponent>();
+	);
+
+	auto entity = testWorld.Create();
+	entity.Add<IndexedComponent<0>>();
+	entity.Add<IndexedComponent<MAX_COMPONENT_COUNT - 1>>();
+	auto& signature = testWorld.GetActivationTableFor(entity.entityID);
+	ASSERT_TRUE(signature.test(0));
+	ASSERT_TRUE(signature.test(MAX_COMPONENT_COUNT - 1));
+	ASSERT_TRUE(signature.Contains(testWorld.ConvertComponentTypesToMask<IndexedComponent<0>, IndexedComponent<MAX_COMPONENT_COUNT - 1>>()));
+	ASSERT_FALSE(signature.Contains(testWorld.ConvertComponentTypesToMask<IndexedComponent<0>, IndexedComponent<1>>()));
+}
+
 class SgComponent : public Component, public ISingletonComponent
 {
 public:
@@ -163,4 +444,599 @@ TEST(GroupTest, EntityCapture) {
 	testEntities[0].Remove<VelocityComponent>();
 	ASSERT_TRUE(g.Count() == 9);
 	ASSERT_TRUE(group2.Count() == 10);
-}
\ No newline at end of file
+}
+
+TEST(GroupTest, GroupEachTest) {
+	World testWorld;
+	auto g = Group::CreateGroup<PositionComponent, VelocityComponent>(&testWorld);
+	for (int i = 0; i < 10; i++)
+	{
+		auto t = testWorld.Create();
+		t.Add(PositionComponent(i, 0, 0));
+		t.Add(VelocityComponent(1, 0, 0));
+	}
+	int count = 0;
+	g.Each<PositionComponent, VelocityComponent>([&](Entity entity, PositionComponent* pPos, VelocityComponent* pVel) {
+		ASSERT_TRUE(entity.Get<PositionComponent>() == pPos);
+		ASSERT_TRUE(entity.Get<VelocityComponent>() == pVel);
+		if (pPos->val.x < 5)
+			entity.Destroy();
+		count++;
+	});
+	ASSERT_TRUE(count == 10);
+	ASSERT_TRUE(g.Count() == 5);
+}
+
+TEST(GroupTest, OwningGroupTest) {
+	World testWorld;
+	std::vector<Entity> testEntities;
+	for (int i = 0; i < 100; i++)
+	{
+		auto t = testWorld.Create();
+		t.Add(PositionComponent(i, 0, 0));
+		if (i % 3 == 0)
+			t.Add(VelocityComponent(1, 0, 0));
+		testEntities.push_back(t);
+	}
+	auto g = Group::CreateOwningGroup<PositionComponent, VelocityComponent>(&testWorld);
+	ASSERT_TRUE(g.IsOwning());
+	ASSERT_ANY_THROW(
+		Group::CreateOwningGroup<PositionComponent>(&testWorld);
+	);
+	auto copy = g;
+	ASSERT_FALSE(copy.IsOwning());
+
+	auto checkGroup = [&]() {
+		size_t count = 0;
+		g.Each<PositionComponent, VelocityComponent>([&](Entity entity, PositionComponent* pPos, VelocityComponent* pVel) {
+			ASSERT_TRUE(entity.Get<PositionComponent>() == pPos);
+			ASSERT_TRUE(entity.Get<VelocityComponent>() == pVel);
+			count++;
+		});
+		ASSERT_TRUE(count == g.Count());
+		ASSERT_TRUE(copy.Count() == g.Count());
+		//members are packed at the front of both pools.
+		PositionComponent* posBase = nullptr;
+		testWorld.View<PositionComponent>().Each([&](Entity entity, PositionComponent* pPos) {
+			posBase = pPos;	//iteration goes backward, the last one is the start of the pool.
+		});
+		VelocityComponent* velBase = nullptr;
+		testWorld.View<VelocityComponent>().Each([&](Entity entity, VelocityComponent* pVel) {
+			velBase = pVel;
+		});
+		testWorld.View<PositionComponent>().Each([&](Entity entity, PositionComponent* pPos) {
+			bool isMember = entity.Has<VelocityComponent>();
+			ASSERT_TRUE(isMember == (pPos < posBase + g.Count()));
+			if (isMember)
+				ASSERT_TRUE(pPos - posBase == entity.Get<VelocityComponent>() - velBase);
+		});
+	};
+	checkGroup();
+	ASSERT_TRUE(g.Count() == 34);
+
+	for (int i = 0; i < 100; i += 2)
+	{
+		if (i % 3 == 0)
+			testEntities[i].Remove<VelocityComponent>();
+		else
+			testEntities[i].Add(VelocityComponent(1, 0, 0));
+	}
+	for (int i = 1; i < 100; i += 5)
+	{
+		testEntities[i].Destroy();
+	}
+	checkGroup();
+	auto c = testWorld.Create();
+	c.Add(VelocityComponent(1, 0, 0));
+	c.Add(PositionComponent(0, 0, 0));
+	checkGroup();
+}
+TEST(GroupTest, ChangeDuringEachTest) {
+	World testWorld;
+	auto group = Group::CreateOwningGroup<PositionComponent, VelocityComponent>(&testWorld);
+	auto entities = testWorld.CreateMany(100, PositionComponent(0, 0, 0), VelocityComponent(1, 0, 0));
+	for (int i = 0; i < 100; i++)
+	{
+		entities[i].Get<PositionComponent>()->val.x = i;
+	}
+	//every member is visited once with its own components, while members leave and new ones enter.
+	std::vector<int> visits(100, 0);
+	group.Each<PositionComponent, VelocityComponent>([&](Entity entity, PositionComponent* pPos, VelocityComponent* pVel) {
+		int x = static_cast<int>(pPos->val.x);
+		ASSERT_TRUE(entity.Get<PositionComponent>() == pPos);
+		visits[x]++;
+		if (x % 2 == 0)
+			entity.Remove<VelocityComponent>();
+		else if (x % 3 == 0)
+			entity.Destroy();
+		testWorld.CreateMany(10, PositionComponent(-1, 0, 0), VelocityComponent(1, 0, 0));
+	});
+	ASSERT_TRUE(std::all_of(visits.begin(), visits.end(), [](int count) { return count == 1; }));
+	ASSERT_TRUE(group.Count() == 1000 + 100 - 50 - 17);
+	//same with range-for.
+	std::fill(visits.begin(), visits.end(), 0);
+	int entered = 0;
+	for (auto entity : group) {
+		int x = static_cast<int>(entity.Get<PositionComponent>()->val.x);
+		if (x < 0) {
+			entered++;
+			entity.Destroy();
+			continue;
+		}
+		visits[x]++;
+		testWorld.CreateMany(10, PositionComponent(-1, 0, 0), VelocityComponent(1, 0, 0));
+	}
+	ASSERT_TRUE(entered == 1000);
+	ASSERT_TRUE(std::count(visits.begin(), visits.end(), 1) == 33);
+	ASSERT_TRUE(group.Count() == 33 + 330);
+}
+
+TEST(GroupTest, OutliveWorldTest) {
+	auto testWorld = std::make_unique<World>();
+	for (int i = 0; i < 10; i++)
+	{
+		auto t = testWorld->Create();
+		t.Add(PositionComponent(i, 0, 0));
+		t.Add(VelocityComponent(1, 0, 0));
+	}
+	auto g = Group::CreateGroup<PositionComponent>(testWorld.get());
+	auto owning = Group::CreateOwningGroup<PositionComponent, VelocityComponent>(testWorld.get());
+	{
+		auto copy = g;
+		ASSERT_TRUE(testWorld->GetStats().groupCount == 3);
+	}
+	ASSERT_TRUE(testWorld->GetStats().groupCount == 2);
+	//groups are destroyed after the world, without touching it.
+	testWorld.reset();
+	ASSERT_TRUE(g.Count() == 10);
+	ASSERT_TRUE(owning.Count() == 10);
+}
+
+TEST(GroupTest, CollectorTest) {
+	World testWorld;
+	auto group = Group::CreateGroup<PositionComponent, VelocityComponent>(&testWorld);
+	auto before = testWorld.Create();
+	before.Add<PositionComponent>();
+	before.Add<VelocityComponent>();
+
+	Collector collector(group);
+	std::vector<Entity> entities;
+	for (int i = 0; i < 10; i++)
+	{
+		auto entity = testWorld.Create();
+		entity.Add<PositionComponent>();
+		entity.Add<VelocityComponent>();
+		entities.push_back(entity);
+	}
+	//entered then left, nothing changed.
+	entities[0].Remove<VelocityComponent>();
+	entities[1].Destroy();
+	ASSERT_EQ(collector.Entered().size(), 8u);
+	ASSERT_TRUE(collector.Left().empty());
+
+	std::vector<EntityID> entered, left;
+	collector.Drain(entered, left);
+	ASSERT_EQ(entered.size(), 8u);
+	ASSERT_TRUE(collector.Empty());
+
+	//left then entered again, nothing changed.
+	entities[2].Remove<VelocityComponent>();
+	entities[2].Add<VelocityComponent>();
+	entities[3].Destroy();
+	before.Remove<PositionComponent>();
+	entities[0].Add<VelocityComponent>();
+	collector.Drain(entered, left);
+	ASSERT_EQ(entered.size(), 1u);
+	ASSERT_TRUE(entered[0] == entities[0].entityID);
+	ASSERT_EQ(left.size(), 2u);
+	ASSERT_FALSE(testWorld.CheckEntityAlive(left[0]) && testWorld.CheckEntityAlive(left[1]));
+}
+
+struct DisabledComponent {};
+struct TagA {};
+struct TagB {};
+
+TEST(GroupTest, FilterTest) {
+	World testWorld;
+	auto group = Group::CreateGroup<PositionComponent, Without<DisabledComponent>, AnyOf<TagA, TagB>>(&testWorld);
+	std::vector<Entity> entities;
+	for (int i = 0; i < 12; i++)
+	{
+		auto entity = testWorld.Create();
+		entity.Add(PositionComponent(i, 0, 0));
+		if (i % 3 == 0)
+			entity.Add<TagA>();
+		if (i % 3 == 1)
+			entity.Add<TagB>();
+		if (i % 2 == 0)
+			entity.Add<DisabledComponent>();
+		entities.push_back(entity);
+	}
+	//1, 3, 5, 7 match.
+	ASSERT_EQ(group.Count(), 4u);
+	int count = 0;
+	testWorld.Each<PositionComponent, Without<DisabledComponent>, AnyOf<TagA, TagB>>([&](Entity entity, PositionComponent* pPos) {
+		ASSERT_TRUE(int(pPos->val.x) % 2 == 1 && int(pPos->val.x) % 3 != 2);
+		count++;
+	});
+	ASSERT_EQ(count, 4);
+	count = 0;
+	for (auto [entity] : testWorld.View<With<PositionComponent, TagA>>()) {
+		count++;
+	}
+	ASSERT_EQ(count, 4);
+
+	//adding an excluded component removes from the group, removing it adds back.
+	entities[1].Add<DisabledComponent>();
+	ASSERT_EQ(group.Count(), 3u);
+	entities[0].Remove<DisabledComponent>();
+	ASSERT_EQ(group.Count(), 4u);
+	entities[1].Destroy();
+	entities[0].Destroy();
+	ASSERT_EQ(group.Count(), 3u);
+	//the mask is compiled once per World.
+	auto pMask = &testWorld.GetQueryMask<PositionComponent, Without<DisabledComponent>>();
+	auto pCachedMask = &testWorld.GetQueryMask<PositionComponent, Without<DisabledComponent>>();
+	ASSERT_TRUE(pMask == pCachedMask);
+}
+
+struct SoAPosition {
+	float x, y, z;
+	using SoALayout = SoAFields<&SoAPosition::x, &SoAPosition::y, &SoAPosition::z>;
+};
+struct SoAVelocity {
+	float x, y, z;
+	using SoALayout = SoAFields<&SoAVelocity::x, &SoAVelocity::y, &SoAVelocity::z>;
+};
+
+TEST(WorldTest, SoAComponentTest) {
+	World testWorld;
+	std::vector<Entity> entities;
+	for (int i = 0; i < 10; i++)
+	{
+		auto entity = testWorld.Create();
+		entity.Add(SoAPosition{ float(i), 0, 0 });
+		if (i % 2 == 0)
+			entity.Add(SoAVelocity{ 1, 2, 3 });
+		entities.push_back(entity);
+	}
+	//write through the proxy pointer.
+	entities[3].Get<SoAPosition>()->y = 5;
+	ASSERT_TRUE(entities[3].Get<SoAPosition>()->y == 5);
+	ASSERT_TRUE(entities[3].Get<SoAVelocity>() == nullptr);
+	entities[1].Remove<SoAPosition>();
+	entities[9].Destroy();
+	ASSERT_TRUE(entities[2].Get<SoAPosition>()->x == 2);
+	ASSERT_TRUE(entities[3].Get<SoAPosition>()->x == 3);
+
+	int count = 0;
+	testWorld.Each<SoAPosition, SoAVelocity>([&](Entity entity, SoAPointer<SoAPosition> pPos, SoAPointer<SoAVelocity> pVel) {
+		pPos->x += pVel->x;
+		count++;
+	});
+	ASSERT_EQ(count, 5);
+	ASSERT_TRUE(entities[4].Get<SoAPosition>()->x == 5);
+
+	//columns of an owning group line up.
+	auto group = Group::CreateOwningGroup<SoAPosition, SoAVelocity>(&testWorld);
+	float* px = group.Column<&SoAPosition::x>();
+	float* vz = group.Column<&SoAVelocity::z>();
+	for (size_t i = 0; i < group.Count(); i++)
+	{
+		px[i] += vz[i];
+	}
+	ASSERT_TRUE(entities[4].Get<SoAPosition>()->x == 8);
+	ASSERT_TRUE(entities[0].Get<SoAPosition>()->x == 4);
+	ASSERT_TRUE(entities[3].Get<SoAPosition>()->x == 3);
+}
+
+TEST(WorldTest, ForEachChunkTest) {
+	World testWorld;
+	//lined up pools, passed in place.
+	auto entities = testWorld.CreateMany(3000, PositionComponent(0, 0, 0), VelocityComponent(1, 2, 3));
+	//velocity only for some, which breaks the runs.
+	for (int i = 0; i < 100; i++)
+	{
+		auto entity = testWorld.Create();
+		entity.Add(PositionComponent(0, 0, 0));
+		if (i % 3 == 0)
+			entity.Add(VelocityComponent(1, 2, 3));
+		entities.push_back(entity);
+	}
+	entities[5].Remove<PositionComponent>();
+	auto since = testWorld.IncrementChangeTick();
+	size_t total = 0, inPlace = 0;
+	testWorld.ForEachChunk<Mut<PositionComponent>, VelocityComponent>([&](size_t count, const EntityID* ids, PositionComponent* pPos, const VelocityComponent* pVel) {
+		ASSERT_TRUE(count <= 256);
+		ASSERT_TRUE(reinterpret_cast<uintptr_t>(pPos) % ChunkAlignment == 0);
+		ASSERT_TRUE(reinterpret_cast<uintptr_t>(pVel) % ChunkAlignment == 0);
+		for (size_t i = 0; i < count; i++)
+		{
+			ASSERT_TRUE(testWorld.CheckEntityAlive(ids[i]));
+			pPos[i].val.x += pVel[i].val.z;
+		}
+		total += count;
+		if (pPos == testWorld.GetEntityHandle(ids[0]).Get<PositionComponent>())
+			inPlace += count;
+	}, 256);
+	ASSERT_EQ(total, 2999u + 34u);
+	ASSERT_TRUE(inPlace > 2900);
+	for (auto& entity : entities) {
+		auto pPos = entity.Get<PositionComponent>();
+		if (pPos != nullptr)
+			ASSERT_TRUE(pPos->val.x == (entity.Has<VelocityComponent>() ? 3 : 0));
+	}
+	//chunks passed in place or copied are both seen as changed.
+	size_t changed = 0;
+	testWorld.Each<Changed<PositionComponent>, VelocityComponent>([&](Entity entity, PositionComponent* pPos, VelocityComponent* pVel) { changed++; }, since);
+	ASSERT_EQ(changed, total);
+	//without Mut<T> nothing is marked.
+	since = testWorld.IncrementChangeTick();
+	size_t read = 0;
+	testWorld.ForEachChunk<PositionComponent, VelocityComponent>([&](size_t count, const EntityID* ids, const PositionComponent* pPos, const VelocityComponent* pVel) {
+		read += count;
+	}, 256);
+	ASSERT_EQ(read, total);
+	changed = 0;
+	testWorld.Each<Changed<PositionComponent>>([&](Entity entity, PositionComponent* pPos) { changed++; }, since);
+	testWorld.Each<Changed<VelocityComponent>>([&](Entity entity, VelocityComponent* pVel) { changed++; }, since);
+	ASSERT_EQ(changed, 0u);
+}
+
+TEST(WorldTest, StatsTest) {
+	World world;
+	auto entities = world.CreateMany(10, PositionComponent(0, 0, 0));
+	entities[0].Add(VelocityComponent(1, 1, 1));
+	entities[1].Destroy();
+	entities[2].Destroy();
+	auto stats = world.GetStats();
+	//the singleton entity is counted too.
+	ASSERT_TRUE(stats.entityCount == 9);
+	ASSERT_TRUE(stats.freeSlots == 2);
+	ASSERT_TRUE(stats.entitySlots == 11);
+	ASSERT_TRUE(stats.groupCount == 0);
+	ASSERT_TRUE(stats.pools.size() == 2);
+	auto& positions = stats.pools[world.ConvertComponentTypeToIndex<PositionComponent>()];
+	ASSERT_TRUE(positions.size == 8);
+	ASSERT_TRUE(positions.capacity >= 8);
+	ASSERT_TRUE(stats.pools[world.ConvertComponentTypeToIndex<VelocityComponent>()].size == 1);
+	{
+		auto group = Group::CreateGroup<PositionComponent>(&world);
+		auto copy = group;
+		ASSERT_TRUE(world.GetStats().groupCount == 2);
+	}
+	ASSERT_TRUE(world.GetStats().groupCount == 0);
+#ifdef RESECS_PROFILING
+	//10 Added in one batch, 1 Added, 2 Removed in two batches.
+	ASSERT_TRUE(stats.eventsDispatched == 13);
+	ASSERT_TRUE(stats.eventBatches == 4);
+	ASSERT_TRUE(positions.eventsDispatched == 12);
+#else
+	ASSERT_TRUE(stats.eventsDispatched == 0);
+#endif
+}
+
+/* Counts live instances, to check the pools construct and destroy components properly. */
+struct LifetimeComponent {
+	std::shared_ptr<int> resource;
+};
+
+TEST(WorldTest, CompactTest) {
+	World world;
+	auto resource = std::make_shared<int>(0);
+	std::vector<Entity> entities;
+	for (int i = 0; i < 1000; i++)
+	{
+		entities.push_back(world.Create());
+		entities.back().Add(LifetimeComponent{ resource });
+		entities.back().Add(PositionComponent(i, 0, 0));
+	}
+	ASSERT_TRUE(resource.use_count() == 1001);
+	//removed/destroyed components release what they hold right away.
+	for (int i = 0; i < 1000; i += 2)
+	{
+		entities[i].Remove<LifetimeComponent>();
+	}
+	ASSERT_TRUE(resource.use_count() == 501);
+	auto kept = entities[10];
+	for (int i = 11; i < 1000; i++)
+	{
+		entities[i].Destroy();
+	}
+	ASSERT_TRUE(resource.use_count() == 6);
+
+	auto before = world.GetStats();
+	world.Compact();
+	auto after = world.GetStats();
+	ASSERT_TRUE(after.entitySlots == 12);	//the singleton and the first 11 entities.
+	ASSERT_TRUE(after.entityCount == before.entityCount);
+	auto& positions = after.pools[world.ConvertComponentTypeToIndex<PositionComponent>()];
+	ASSERT_TRUE(positions.capacity == 11);
+	ASSERT_TRUE(positions.indexSize == 12);
+	ASSERT_TRUE(kept.Get<PositionComponent>()->val.x == 10);
+	ASSERT_TRUE(resource.use_count() == 6);
+	//pools are sorted by entity index.
+	std::vector<int> order;
+	world.Each<PositionComponent>([&](Entity entity, PositionComponent* pPos) { order.push_back(entity.entityID.index); });
+	ASSERT_TRUE(std::is_sorted(order.rbegin(), order.rend()));
+
+	//stale handles of dropped slots stay dead when their slots come back.
+	for (int i = 0; i < 1000; i++)
+	{
+		world.Create();
+	}
+	for (int i = 11; i < 1000; i++)
+	{
+		ASSERT_FALSE(entities[i].IsAlive());
+	}
+}
+
+/* Counts bytes going through it, to check that a World allocates from the resource it's given. */
+class CountingResource : public std::pmr::memory_resource {
+public:
+	size_t liveBytes = 0;
+	size_t allocations = 0;
+protected:
+	void* do_allocate(size_t bytes, size_t alignment) override {
+		liveBytes += bytes;
+		allocations++;
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+	void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+		liveBytes -= bytes;
+		std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+	}
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+		return this == &other;
+	}
+};
+
+TEST(WorldTest, MemoryResourceTest) {
+	CountingResource counting;
+	{
+		World world(&counting);
+		ASSERT_TRUE(world.GetMemoryResource() == &counting);
+		auto entities = world.CreateMany(1000, PositionComponent(0, 0, 0));
+		for (int i = 0; i < 1000; i += 2)
+		{
+			entities[i].Add(VelocityComponent(1, 0, 0));
+		}
+		ASSERT_TRUE(counting.liveBytes > 1000 * (sizeof(EntityID) + sizeof(PositionComponent)));
+		//groups, their signals and collectors allocate from the resource of the World too.
+		auto allocations = counting.allocations;
+		auto group = Group::CreateGroup<PositionComponent, VelocityComponent>(&world);
+		Collector collector(group);
+		ASSERT_TRUE(counting.allocations > allocations);
+		ASSERT_TRUE(group.Count() == 500);
+		for (int i = 0; i < 1000; i += 4)
+		{
+			entities[i].Destroy();
+		}
+		ASSERT_TRUE(group.Count() == 250);
+		ASSERT_TRUE(collector.Left().size() == 250);
+		world.Compact();
+		ASSERT_TRUE(entities[2].Get<VelocityComponent>()->val.x == 1);
+	}
+	//everything was given back through the resource.
+	ASSERT_TRUE(counting.liveBytes == 0);
+
+	Arena arena(1 << 16);
+	{
+		World world(&arena);
+		world.CreateMany(10000, PositionComponent(0, 0, 0), VelocityComponent(1, 0, 0));
+		auto group = Group::CreateOwningGroup<PositionComponent, VelocityComponent>(&world);
+		ASSERT_TRUE(group.Count() == 10000);
+		ASSERT_TRUE(arena.BytesAllocated() > 10000 * (sizeof(PositionComponent) + sizeof(VelocityComponent)));
+		world.Each<PositionComponent, VelocityComponent>([](Entity entity, PositionComponent* pPos, VelocityComponent* pVel) {
+			pPos->val.x += pVel->val.x;
+		});
+		int moved = 0;
+		world.Each<PositionComponent>([&](Entity entity, PositionComponent* pPos) { moved += pPos->val.x == 1; });
+		ASSERT_TRUE(moved == 10000);
+	}
+	ASSERT_TRUE(arena.BytesAllocated() == 0);
+	arena.Release();
+	//the arena can be used again.
+	World next(&arena);
+	next.Create().Add(PositionComponent(0, 0, 0));
+	ASSERT_TRUE(next.EntityCount() == 2);
+}
+
+TEST(WorldTest, MonotonicArenaTest) {
+	CountingResource upstream;
+	Arena arena(1 << 16, &upstream, Arena::Mode::Monotonic);
+	size_t upstreamAllocations = 0;
+	for (int level = 0; level < 3; level++)
+	{
+		{
+			World world(&arena);
+			auto group = Group::CreateGroup<PositionComponent, VelocityComponent>(&world);
+			Collector collector(group);
+			CommandBuffer buffer(&world);
+			for (int i = 0; i < 1000; i++)
+			{
+				auto entity = buffer.Create();
+				buffer.Add(entity, PositionComponent(0, 0, 0));
+				buffer.Add(entity, VelocityComponent(1, 0, 0));
+			}
+			buffer.Playback();
+			ASSERT_TRUE(collector.Entered().size() == 1000);
+			ArchetypeWorld archetypes(&arena);
+			archetypes.Add(archetypes.Create(), PositionComponent(0, 0, 0));
+			ASSERT_TRUE(arena.BytesAllocated() > 1000 * (sizeof(PositionComponent) + sizeof(VelocityComponent)));
+		}
+		//nothing went back upstream, the World was destroyed without a single free.
+		ASSERT_TRUE(upstream.liveBytes == arena.BytesReserved());
+		arena.Reset();
+		ASSERT_TRUE(arena.BytesAllocated() == 0);
+		//later levels fit in the chunks of the first one.
+		if (level == 0)
+			upstreamAllocations = upstream.allocations;
+		ASSERT_TRUE(upstream.allocations == upstreamAllocations);
+		ASSERT_TRUE(upstream.liveBytes == arena.BytesReserved());
+	}
+	arena.Release();
+	ASSERT_TRUE(upstream.liveBytes == 0);
+}
+
+struct PagedComponent {
+	using Paging = Paged<8>;
+	int value;
+	std::shared_ptr<int> life;
+	PagedComponent(int value = 0, std::shared_ptr<int> life = nullptr) : value(value), life(life) {}
+};
+
+TEST(WorldTest, PagedComponentTest) {
+	World world;
+	auto life = std::make_shared<int>(0);
+	std::vector<Entity> entities;
+	std::vector<PagedComponent*> pointers;
+	for (int i = 0; i < 100; i++)
+	{
+		entities.push_back(world.Create());
+		pointers.push_back(entities.back().Add(PagedComponent(i, life)));
+		entities.back().Add(PositionComponent(i, 0, 0));
+	}
+	ASSERT_TRUE(life.use_count() == 101);
+	//growing, removing others, owning groups and Compact() never move a paged component.
+	auto group = Group::CreateOwningGroup<PagedComponent, PositionComponent>(&world);
+	for (int i = 0; i < 100; i += 3)
+	{
+		entities[i].Remove<PagedComponent>();
+	}
+	ASSERT_TRUE(life.use_count() == 67);
+	auto more = world.CreateMany(1000, PagedComponent(-1, life));
+	ASSERT_TRUE(life.use_count() == 1067);
+	for (int i = 0; i < 100; i++)
+	{
+		if (i % 3 == 0)
+			continue;
+		ASSERT_TRUE(entities[i].Get<PagedComponent>() == pointers[i]);
+		ASSERT_TRUE(pointers[i]->value == i);
+	}
+	ASSERT_TRUE(group.Count() == 66);
+	int sum = 0;
+	group.Each<PagedComponent, PositionComponent>([&](Entity entity, PagedComponent* pPaged, PositionComponent* pPos) {
+		ASSERT_TRUE(pPaged->value == pPos->val.x);
+		sum += pPaged->value;
+	});
+	ASSERT_TRUE(sum == 4950 - 1683);	//every i not multiple of 3.
+
+	for (auto& entity : more) {
+		entity.Destroy();
+	}
+	ASSERT_TRUE(life.use_count() == 67);
+	auto pool = world.GetStats().pools[world.ConvertComponentTypeToIndex<PagedComponent>()];
+	ASSERT_TRUE(pool.capacity >= 1066);
+	world.Compact();
+	pool = world.GetStats().pools[world.ConvertComponentTypeToIndex<PagedComponent>()];
+	ASSERT_TRUE(pool.size == 66);
+	ASSERT_TRUE(pool.capacity == 13 * 8);	//the pages of the first 100 components, the others are empty.
+	for (int i = 1; i < 100; i += 3)
+	{
+		ASSERT_TRUE(entities[i].Get<PagedComponent>() == pointers[i]);
+	}
+	world.Each<PagedComponent>([&](Entity entity, PagedComponent* pPaged) {
+		ASSERT_TRUE(pPaged->value == entity.Get<PositionComponent>()->val.x);
+	});
+}